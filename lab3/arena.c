@@ -0,0 +1,386 @@
+#include "board.h"
+#include "bitboard.h"
+#include "endgame.h"
+#include "heuristic.h"
+#include "opening_book.h"
+#include "search.h"
+#include "tablebase.h"
+#include "transposition.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Arena: turniej dwóch konfiguracji silnika bez serwera. Silnik jest linkowany bezpośrednio,
+// gry toczą się równolegle (jedna gra na wątek), a wynik to W/L/D, Elo z przedziałem ufności
+// i czas na ruch każdej konfiguracji.
+
+#define ARENA_DEFAULT_GAMES 100
+#define ARENA_DEFAULT_DEPTH 6
+#define ARENA_DEFAULT_RANDOM_PLIES 2
+#define ARENA_DEFAULT_TT_MB 16
+
+// Konfiguracja jednego silnika
+typedef struct {
+    int depth;
+    int timeLimitMs;    // 0 = tylko limit głębokości
+    int solveEmpty;     // 0 = bez dokładnego solvera końcówek
+    int ttMegabytes;
+    bool useBook;
+    bool useTablebase;
+} EngineConfig;
+
+// Stan silnika w jednym wątku areny - odpowiednik osobnego procesu bota
+typedef struct {
+    TranspositionTable tt;
+    EndgameCache endgame;
+    SearchContext ctx;
+} EngineState;
+
+// Czas i węzły jednego silnika (sumy ze wszystkich gier)
+typedef struct {
+    long long searches;     // Ruchy z przeszukiwania
+    long long bookMoves;
+    long long nodes;
+    long long depthSum;
+    long long errors;       // Brak ruchu lub ruch na zajęte pole (przegrana jak na serwerze)
+    double totalMs;
+    double maxMs;
+} EngineStats;
+
+// Wynik jednej gry z perspektywy silnika A
+typedef struct {
+    int result;             // 1 = wygrana A, 0 = remis, -1 = przegrana A
+    bool aFirst;            // A grał jako gracz 1 (pierwszy ruch)
+} GameRecord;
+
+EngineConfig engines[2];
+EngineStats engineStats[2];
+Tablebase tablebase = { .maxEmpty = -1 };
+int randomPlies = ARENA_DEFAULT_RANDOM_PLIES;
+uint64_t arenaSeed = 1;
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec * 1e-6;
+}
+
+// === GRA ===
+
+// Losowe otwarcie: 'plies' ruchów, które niczego nie rozstrzygają. Obie gry pary dostają
+// to samo otwarcie (to samo ziarno) ze zamienionymi kolorami - przeszukiwanie jest
+// deterministyczne, więc bez tego wszystkie gry byłyby identyczne.
+static int randomOpening(BitBoard* bb, int plies, uint64_t seed) {
+    int toMove = 1;
+    for (int ply = 0; ply < plies; ply++) {
+        int cells[BB_CELLS];
+        int count = 0;
+        for (uint32_t e = bbEmpty(bb); e; e &= e - 1) {
+            int cell = __builtin_ctz(e);
+            if (!bbWouldWin(bb, toMove, cell) && !bbWouldLose(bb, toMove, cell)) cells[count++] = cell;
+        }
+        if (count == 0) break;
+        bbPlace(bb, cells[bbRandom64(&seed) % count], toMove);
+        toMove = 3 - toMove;
+    }
+    return toMove;
+}
+
+// Ruch silnika 'engine' (0 = A, 1 = B): książka otwarć, potem przeszukiwanie jak w bestMove()
+static int engineMove(int engine, EngineState* state, const BitBoard* bb, int toMove, EngineStats* stats) {
+    const EngineConfig* cfg = &engines[engine];
+    if (cfg->useBook) {
+        int move = getOpeningMove(bb, toMove);
+        if (move != 0) {
+            stats->bookMoves++;
+            return move;
+        }
+    }
+
+    ttNewSearch(&state->tt);
+    searchSetPosition(&state->ctx, bb);
+    SearchLimits limits = { cfg->depth, cfg->timeLimitMs, 1, cfg->solveEmpty, false, true };
+    double start = nowMs();
+    SearchResult result = searchBestMove(&state->ctx, toMove, &limits);
+    double elapsed = nowMs() - start;
+
+    stats->searches++;
+    stats->nodes += result.nodes;
+    stats->depthSum += result.depth;
+    stats->totalMs += elapsed;
+    if (elapsed > stats->maxMs) stats->maxMs = elapsed;
+    return result.move;
+}
+
+static GameRecord playGame(int game, EngineState states[2], EngineStats stats[2]) {
+    GameRecord record = { 0, (game % 2) == 0 };
+    // Silnik grający graczem 1 i 2
+    int engineOf[3] = { 0, record.aFirst ? 0 : 1, record.aFirst ? 1 : 0 };
+
+    // Każdy silnik zaczyna grę od pustej tablicy transpozycji i świeżego kontekstu
+    for (int e = 0; e < 2; e++) {
+        ttClear(&states[e].tt);
+        searchInit(&states[e].ctx, &states[e].tt);
+        states[e].ctx.endgame = (engines[e].solveEmpty > 0) ? &states[e].endgame : NULL;
+        states[e].ctx.tablebase = (engines[e].useTablebase && tablebase.map != NULL) ? &tablebase : NULL;
+    }
+
+    BitBoard bb;
+    bbClear(&bb);
+    uint64_t seed = arenaSeed ^ ((uint64_t)(game / 2) * 0x9E3779B97F4A7C15ull);
+    int toMove = randomOpening(&bb, randomPlies, seed);
+
+    int winner = 0;  // 0 = remis (pełna plansza)
+    while (bbEmpty(&bb)) {
+        int engine = engineOf[toMove];
+        int move = engineMove(engine, &states[engine], &bb, toMove, &stats[engine]);
+        int cell = (move >= 11 && move <= 55) ? bbMoveToCell(move) : -1;
+        if (cell < 0 || cell >= BB_CELLS || bbCellOwner(&bb, cell) != 0) {
+            stats[engine].errors++;
+            winner = 3 - toMove;
+            break;
+        }
+        bbPlace(&bb, cell, toMove);
+        // 4 w rzędzie wygrywa przed 3 w rzędzie
+        if (bbWinCheck(&bb, toMove)) {
+            winner = toMove;
+            break;
+        }
+        if (bbLoseCheck(&bb, toMove)) {
+            winner = 3 - toMove;
+            break;
+        }
+        toMove = 3 - toMove;
+    }
+
+    if (winner != 0) record.result = (engineOf[winner] == 0) ? 1 : -1;
+    return record;
+}
+
+// === STATYSTYKA ===
+
+// Elo z oczekiwanego wyniku; wynik obcięty do [0.001, 0.999], żeby 100% nie dawało nieskończoności
+static double eloFromScore(double score) {
+    if (score < 0.001) score = 0.001;
+    if (score > 0.999) score = 0.999;
+    return -400.0 * log10(1.0 / score - 1.0);
+}
+
+static void printResults(int wins, int losses, int draws) {
+    int games = wins + losses + draws;
+    if (games == 0) return;
+    double score = (wins + 0.5 * draws) / games;
+    // Wariancja wyniku jednej gry (1 / 0.5 / 0) i 95% przedział dla średniej
+    double variance = (wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) +
+                       losses * score * score) / games;
+    double margin = 1.96 * sqrt(variance / games);
+    double elo = eloFromScore(score);
+    double eloLow = eloFromScore(score - margin);
+    double eloHigh = eloFromScore(score + margin);
+    // Prawdopodobieństwo, że A jest silniejszy (remisy pominięte)
+    double los = (wins + losses > 0) ? 0.5 * (1.0 + erf((wins - losses) / sqrt(2.0 * (wins + losses)))) : 0.5;
+    printf("Games: %d  A: +%d -%d =%d  score %.1f%%\n", games, wins, losses, draws, 100.0 * score);
+    printf("Elo A-B: %+.1f +/- %.1f (95%%: %+.1f .. %+.1f), LOS %.1f%%\n", elo, (eloHigh - eloLow) / 2.0,
+           eloLow, eloHigh, 100.0 * los);
+}
+
+static void printEngine(char name, const EngineConfig* cfg, const EngineStats* stats) {
+    printf("%c: depth=%d time-ms=%d solve-empty=%d tt-mb=%d book=%s tb=%s\n", name, cfg->depth,
+           cfg->timeLimitMs, cfg->solveEmpty, cfg->ttMegabytes, cfg->useBook ? "on" : "off",
+           cfg->useTablebase ? "on" : "off");
+    if (stats == NULL) return;
+    double searches = stats->searches > 0 ? (double)stats->searches : 1.0;
+    printf("   searched moves=%lld book moves=%lld errors=%lld\n", stats->searches, stats->bookMoves, stats->errors);
+    printf("   time/move avg=%.2f ms max=%.1f ms, nodes/move=%.0f, avg depth=%.2f\n", stats->totalMs / searches,
+           stats->maxMs, stats->nodes / searches, stats->depthSum / searches);
+}
+
+// === KONFIGURACJA ===
+
+// Opcja silnika bez prefiksu (--depth=, --time-ms=, ...); false = nieznana opcja
+static bool parseEngineOption(const char* option, EngineConfig* cfg) {
+    if (sscanf(option, "depth=%d", &cfg->depth) == 1) return true;
+    if (sscanf(option, "time-ms=%d", &cfg->timeLimitMs) == 1) return true;
+    if (sscanf(option, "solve-empty=%d", &cfg->solveEmpty) == 1) return true;
+    if (sscanf(option, "tt-mb=%d", &cfg->ttMegabytes) == 1) return true;
+    if (strcmp(option, "book") == 0) cfg->useBook = true;
+    else if (strcmp(option, "no-book") == 0) cfg->useBook = false;
+    else if (strcmp(option, "tb") == 0) cfg->useTablebase = true;
+    else if (strcmp(option, "no-tb") == 0) cfg->useTablebase = false;
+    else return false;
+    return true;
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--games=N] [--parallel=P] [--random-plies=K] [--seed=S] [--tb-file=F] [--book-file=F]\n"
+           "          [engine options for both] [--a-<option>] [--b-<option>]\n", program);
+    printf("Engine options: --depth=D --time-ms=T --solve-empty=E --tt-mb=M --book|--no-book --tb|--no-tb\n");
+    printf("Example: %s --games=400 --a-depth=8 --b-depth=6 --time-ms=200\n", program);
+}
+
+int main(int argc, char *argv[]) {
+    int games = ARENA_DEFAULT_GAMES;
+    int parallel = 1;
+#ifdef _OPENMP
+    parallel = omp_get_max_threads();
+#endif
+    const char* tbFile = TB_DEFAULT_FILE;
+    const char* bookFile = "opening_book_2.txt";
+
+    EngineConfig defaults = { ARENA_DEFAULT_DEPTH, 0, EG_DEFAULT_EMPTY, ARENA_DEFAULT_TT_MB, false, true };
+    engines[0] = engines[1] = defaults;
+
+    // Opcje wspólne najpierw, potem --a-/--b-, żeby nadpisywały wspólne niezależnie od kolejności
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg = argv[i];
+            if (strncmp(arg, "--", 2) != 0) {
+                if (pass == 0) printf("Unknown argument: %s\n", arg);
+                continue;
+            }
+            bool prefixed = strncmp(arg, "--a-", 4) == 0 || strncmp(arg, "--b-", 4) == 0;
+            if (pass == 0 && !prefixed) {
+                if (sscanf(arg, "--games=%d", &games) == 1) continue;
+                if (sscanf(arg, "--parallel=%d", &parallel) == 1) continue;
+                if (sscanf(arg, "--random-plies=%d", &randomPlies) == 1) continue;
+                if (strstr(arg, "--seed=") == arg) {
+                    arenaSeed = strtoull(arg + strlen("--seed="), NULL, 10);
+                    continue;
+                }
+                if (strstr(arg, "--tb-file=") == arg) {
+                    tbFile = arg + strlen("--tb-file=");
+                    continue;
+                }
+                if (strstr(arg, "--book-file=") == arg) {
+                    bookFile = arg + strlen("--book-file=");
+                    continue;
+                }
+                if (strcmp(arg, "--help") == 0) {
+                    printUsage(argv[0]);
+                    return 0;
+                }
+                bool both = parseEngineOption(arg + 2, &engines[0]);
+                parseEngineOption(arg + 2, &engines[1]);
+                if (!both) printf("Unknown option: %s\n", arg);
+            } else if (pass == 1 && prefixed) {
+                int engine = (arg[2] == 'a') ? 0 : 1;
+                if (!parseEngineOption(arg + 4, &engines[engine])) printf("Unknown option: %s\n", arg);
+            }
+        }
+    }
+    if (games < 1) games = 1;
+    if (parallel < 1) parallel = 1;
+    if (parallel > games) parallel = games;
+    if (randomPlies < 0) randomPlies = 0;
+
+    initBitboards();
+    initEvaluation();
+
+    printf("=== ARENA ===\n");
+    printEngine('A', &engines[0], NULL);
+    printEngine('B', &engines[1], NULL);
+    printf("Games: %d (%d in parallel), random opening plies: %d, seed: %llu\n", games, parallel, randomPlies,
+           (unsigned long long)arenaSeed);
+
+    if (engines[0].useTablebase || engines[1].useTablebase) {
+        tbOpen(&tablebase, tbFile);  // Brak pliku nie jest błędem
+    }
+    if (engines[0].useBook || engines[1].useBook) {
+        loadOpeningBook(bookFile);   // Tylko odczyt w trakcie gier - wspólna dla wszystkich wątków
+    }
+
+    // Osobne tablice i pamięć końcówek dla każdego silnika w każdym wątku
+    EngineState* states = calloc((size_t)parallel * 2, sizeof(EngineState));
+    GameRecord* records = calloc(games, sizeof(GameRecord));
+    if (!states || !records) {
+        printf("Error: Cannot allocate arena state!\n");
+        return -1;
+    }
+    for (int i = 0; i < parallel * 2; i++) {
+        const EngineConfig* cfg = &engines[i % 2];
+        if (!ttInit(&states[i].tt, cfg->ttMegabytes)) return -1;
+        if (cfg->solveEmpty > 0 && !egInit(&states[i].endgame, EG_DEFAULT_MB)) return -1;
+    }
+
+    int done = 0, wins = 0, losses = 0, draws = 0;
+    int reportEvery = (games >= 20) ? games / 10 : 1;
+    double start = nowMs();
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(parallel)
+#endif
+    {
+        int threadId = 0;
+#ifdef _OPENMP
+        threadId = omp_get_thread_num();
+#endif
+        EngineStats local[2];
+        memset(local, 0, sizeof(local));
+
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (int game = 0; game < games; game++) {
+            records[game] = playGame(game, &states[threadId * 2], local);
+#ifdef _OPENMP
+            #pragma omp critical(arena_progress)
+#endif
+            {
+                done++;
+                if (records[game].result > 0) wins++;
+                else if (records[game].result < 0) losses++;
+                else draws++;
+                if (done % reportEvery == 0 && done < games) {
+                    printf("[ARENA] %d/%d games: A +%d -%d =%d (%.1f s)\n", done, games, wins, losses, draws,
+                           (nowMs() - start) / 1000.0);
+                    fflush(stdout);
+                }
+            }
+        }
+
+#ifdef _OPENMP
+        #pragma omp critical(arena_stats)
+#endif
+        for (int e = 0; e < 2; e++) {
+            engineStats[e].searches += local[e].searches;
+            engineStats[e].bookMoves += local[e].bookMoves;
+            engineStats[e].nodes += local[e].nodes;
+            engineStats[e].depthSum += local[e].depthSum;
+            engineStats[e].errors += local[e].errors;
+            engineStats[e].totalMs += local[e].totalMs;
+            if (local[e].maxMs > engineStats[e].maxMs) engineStats[e].maxMs = local[e].maxMs;
+        }
+    }
+    double elapsed = nowMs() - start;
+
+    // Wyniki według koloru A (przewaga pierwszego ruchu)
+    int firstWins = 0, firstLosses = 0, firstDraws = 0;
+    for (int game = 0; game < games; game++) {
+        if (!records[game].aFirst) continue;
+        if (records[game].result > 0) firstWins++;
+        else if (records[game].result < 0) firstLosses++;
+        else firstDraws++;
+    }
+
+    printf("\n=== ARENA RESULTS ===\n");
+    printResults(wins, losses, draws);
+    printf("A as player 1: +%d -%d =%d, A as player 2: +%d -%d =%d\n", firstWins, firstLosses, firstDraws,
+           wins - firstWins, losses - firstLosses, draws - firstDraws);
+    printEngine('A', &engines[0], &engineStats[0]);
+    printEngine('B', &engines[1], &engineStats[1]);
+    printf("Total time: %.1f s (%.2f games/s)\n", elapsed / 1000.0, games * 1000.0 / elapsed);
+
+    for (int i = 0; i < parallel * 2; i++) {
+        ttFree(&states[i].tt);
+        egFree(&states[i].endgame);
+    }
+    free(states);
+    free(records);
+    freeOpeningBook();
+    tbClose(&tablebase);
+    return 0;
+}
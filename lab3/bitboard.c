@@ -0,0 +1,168 @@
+#include "bitboard.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Zewnętrzne definicje z board.h
+extern const int win[28][4][2];
+extern const int lose[48][3][2];
+
+uint32_t winMasks[BB_WIN_PATTERNS];
+uint32_t loseMasks[BB_LOSE_PATTERNS];
+
+uint32_t cellWinMasks[BB_CELLS][BB_MAX_WIN_PER_CELL];
+uint32_t cellLoseMasks[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+int cellWinCount[BB_CELLS];
+int cellLoseCount[BB_CELLS];
+uint8_t cellWinLine[BB_CELLS][BB_MAX_WIN_PER_CELL];
+uint8_t cellWinDigit[BB_CELLS][BB_MAX_WIN_PER_CELL];
+uint8_t cellLoseLine[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+uint8_t cellLoseDigit[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+uint8_t winCodeShape[BB_WIN_LINE_STATES];
+uint8_t loseCodeShape[BB_LOSE_LINE_STATES];
+
+int bbSymCell[BB_SYMMETRIES][BB_CELLS];
+int bbSymInverse[BB_SYMMETRIES][BB_CELLS];
+uint32_t bbSymByte[BB_SYMMETRIES][4][256];
+
+uint64_t zobristKeys[3][BB_CELLS];
+uint64_t zobristSym[BB_SYMMETRIES][3][BB_CELLS];
+
+// Transformacja pola (r, c) - te same wzory co rotate90/flipHorizontal/... w opening_book.c
+static int symmetryCell(int t, int r, int c) {
+    switch (t) {
+        case 1: return c * 5 + (4 - r);              // obrót 90
+        case 2: return (4 - r) * 5 + (4 - c);        // obrót 180
+        case 3: return (4 - c) * 5 + r;              // obrót 270
+        case 4: return r * 5 + (4 - c);              // odbicie poziome
+        case 5: return (4 - r) * 5 + c;              // odbicie pionowe
+        case 6: return c * 5 + r;                    // przekątna główna
+        case 7: return (4 - c) * 5 + (4 - r);        // anty-przekątna
+        default: return r * 5 + c;                   // identyczność
+    }
+}
+
+static bool bitboardsInitialized = false;
+
+// Generator splitmix64 - stałe ziarno, żeby klucze były powtarzalne między uruchomieniami
+uint64_t bbRandom64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void initBitboards(void) {
+    if (bitboardsInitialized) return;
+
+    for (int i = 0; i < BB_WIN_PATTERNS; i++) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 4; k++) {
+            mask |= 1u << (win[i][k][0] * 5 + win[i][k][1]);
+        }
+        winMasks[i] = mask;
+    }
+
+    for (int i = 0; i < BB_LOSE_PATTERNS; i++) {
+        uint32_t mask = 0;
+        for (int k = 0; k < 3; k++) {
+            mask |= 1u << (lose[i][k][0] * 5 + lose[i][k][1]);
+        }
+        loseMasks[i] = mask;
+    }
+
+    // Indeks linii przez pole - po ruchu wystarczy sprawdzić tylko te wzorce
+    for (int cell = 0; cell < BB_CELLS; cell++) {
+        cellWinCount[cell] = 0;
+        cellLoseCount[cell] = 0;
+        for (int i = 0; i < BB_WIN_PATTERNS; i++) {
+            if (winMasks[i] & (1u << cell)) {
+                // Pozycja pola w linii = liczba pól linii o mniejszym numerze
+                int k = __builtin_popcount(winMasks[i] & ((1u << cell) - 1));
+                cellWinLine[cell][cellWinCount[cell]] = i;
+                cellWinDigit[cell][cellWinCount[cell]] = (k == 0) ? 1 : (k == 1) ? 3 : (k == 2) ? 9 : 27;
+                cellWinMasks[cell][cellWinCount[cell]++] = winMasks[i];
+            }
+        }
+        for (int i = 0; i < BB_LOSE_PATTERNS; i++) {
+            if (loseMasks[i] & (1u << cell)) {
+                int k = __builtin_popcount(loseMasks[i] & ((1u << cell) - 1));
+                cellLoseLine[cell][cellLoseCount[cell]] = i;
+                cellLoseDigit[cell][cellLoseCount[cell]] = (k == 0) ? 1 : (k == 1) ? 3 : 9;
+                cellLoseMasks[cell][cellLoseCount[cell]++] = loseMasks[i];
+            }
+        }
+    }
+
+    // Kształt linii dla każdego kodu trójkowego
+    for (int code = 0; code < BB_WIN_LINE_STATES; code++) {
+        int n[3] = { 0, 0, 0 };
+        for (int k = 0, c = code; k < 4; k++, c /= 3) n[c % 3]++;
+        winCodeShape[code] = bbWinShape(n[1], n[2]);
+    }
+    for (int code = 0; code < BB_LOSE_LINE_STATES; code++) {
+        int n[3] = { 0, 0, 0 };
+        for (int k = 0, c = code; k < 3; k++, c /= 3) n[c % 3]++;
+        loseCodeShape[code] = bbLoseShape(n[1], n[2]);
+    }
+
+    // Tablice symetrii pól
+    for (int t = 0; t < BB_SYMMETRIES; t++) {
+        for (int cell = 0; cell < BB_CELLS; cell++) {
+            int target = symmetryCell(t, cell / 5, cell % 5);
+            bbSymCell[t][cell] = target;
+            bbSymInverse[t][target] = cell;
+        }
+        for (int chunk = 0; chunk < 4; chunk++) {
+            for (int byte = 0; byte < 256; byte++) {
+                uint32_t mask = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    int cell = chunk * 8 + bit;
+                    if ((byte & (1 << bit)) && cell < BB_CELLS) mask |= 1u << bbSymCell[t][cell];
+                }
+                bbSymByte[t][chunk][byte] = mask;
+            }
+        }
+    }
+
+    // Klucze Zobrista (zobristKeys[0] zostaje zerowe - puste pole nie zmienia klucza)
+    uint64_t seed = 0x5A0B2025ull;
+    for (int player = 1; player <= 2; player++) {
+        for (int cell = 0; cell < BB_CELLS; cell++) {
+            zobristKeys[player][cell] = bbRandom64(&seed);
+        }
+    }
+    for (int t = 0; t < BB_SYMMETRIES; t++) {
+        for (int player = 0; player <= 2; player++) {
+            for (int cell = 0; cell < BB_CELLS; cell++) {
+                zobristSym[t][player][cell] = zobristKeys[player][bbSymCell[t][cell]];
+            }
+        }
+    }
+
+    bitboardsInitialized = true;
+}
+
+void bbClear(BitBoard* bb) {
+    memset(bb, 0, sizeof(*bb));
+    bb->winShapes[bbWinShape(0, 0)] = BB_WIN_PATTERNS;
+    bb->loseShapes[bbLoseShape(0, 0)] = BB_LOSE_PATTERNS;
+}
+
+void bbFromBoard(BitBoard* bb, int src[5][5]) {
+    bbClear(bb);
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            if (src[i][j] == 1 || src[i][j] == 2) {
+                bbPlace(bb, i * 5 + j, src[i][j]);
+            }
+        }
+    }
+}
+
+void bbToBoard(const BitBoard* bb, int dst[5][5]) {
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            dst[i][j] = bbCellOwner(bb, i * 5 + j);
+        }
+    }
+}
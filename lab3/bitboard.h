@@ -0,0 +1,239 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Plansza 5x5 jako maski bitowe: bit (wiersz * 5 + kolumna) odpowiada polu planszy
+#define BB_CELLS 25
+#define BB_FULL 0x1FFFFFFu
+#define BB_MAX_WIN_PER_CELL 8    // Najwięcej linii 4 przechodzi przez środek planszy
+#define BB_MAX_LOSE_PER_CELL 12  // Najwięcej linii 3 przechodzi przez środek planszy
+
+#define BB_WIN_PATTERNS 28
+#define BB_LOSE_PATTERNS 48
+
+// Kształt linii = (liczba kamieni gracza 1, liczba kamieni gracza 2), indeks n1 * 5 + n2 dla linii 4
+// i n1 * 4 + n2 dla linii 3. Ocena zależy tylko od tego, ile linii ma dany kształt.
+#define BB_WIN_SHAPES 25
+#define BB_LOSE_SHAPES 16
+#define bbWinShape(n1, n2) ((n1) * 5 + (n2))
+#define bbLoseShape(n1, n2) ((n1) * 4 + (n2))
+
+// Pozycja w silniku bitboardowym - jedna 25-bitowa maska na gracza.
+// Kody linii i liczniki kształtów są aktualizowane przy bbPlace/bbRemove tylko na liniach
+// przez zmienione pole, więc ocena liścia nie musi przechodzić po planszy.
+typedef struct {
+    uint32_t stones[3];  // stones[1] - gracz 1, stones[2] - gracz 2 (stones[0] nieużywane)
+    uint64_t hash[8];    // Klucze Zobrista pozycji w 8 orientacjach (aktualizowane przy bbPlace/bbRemove)
+    uint8_t winCodes[BB_WIN_PATTERNS];     // Kod trójkowy każdej linii 4
+    uint8_t loseCodes[BB_LOSE_PATTERNS];   // Kod trójkowy każdej linii 3
+    uint8_t winShapes[BB_WIN_SHAPES];      // Liczba linii 4 o danym kształcie
+    uint8_t loseShapes[BB_LOSE_SHAPES];    // Liczba linii 3 o danym kształcie
+} BitBoard;
+
+// Wzorce wygranej (4 w rzędzie) i przegranej (3 w rzędzie) jako maski - budowane z tablic board.h
+extern uint32_t winMasks[BB_WIN_PATTERNS];
+extern uint32_t loseMasks[BB_LOSE_PATTERNS];
+
+// Indeks linii przez pole: wzorce wygranej/przegranej zawierające dane pole
+extern uint32_t cellWinMasks[BB_CELLS][BB_MAX_WIN_PER_CELL];
+extern uint32_t cellLoseMasks[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+extern int cellWinCount[BB_CELLS];
+extern int cellLoseCount[BB_CELLS];
+
+// Kod linii w systemie trójkowym: cyfra k = właściciel k-tego pola linii (0 puste, 1, 2).
+// cellWinLine/cellLoseLine - numery linii przez pole, cellWinDigit/cellLoseDigit - waga 3^k pola w linii
+#define BB_WIN_LINE_STATES 81   // 3^4
+#define BB_LOSE_LINE_STATES 27  // 3^3
+extern uint8_t cellWinLine[BB_CELLS][BB_MAX_WIN_PER_CELL];
+extern uint8_t cellWinDigit[BB_CELLS][BB_MAX_WIN_PER_CELL];
+extern uint8_t cellLoseLine[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+extern uint8_t cellLoseDigit[BB_CELLS][BB_MAX_LOSE_PER_CELL];
+extern uint8_t winCodeShape[BB_WIN_LINE_STATES];    // Kod linii 4 -> kształt
+extern uint8_t loseCodeShape[BB_LOSE_LINE_STATES];  // Kod linii 3 -> kształt
+
+// Symetrie planszy 5x5 (grupa D4) w kolejności transforms[] z opening_book.c:
+// 0 identyczność, 1 obrót 90, 2 obrót 180, 3 obrót 270,
+// 4 odbicie poziome, 5 odbicie pionowe, 6 przekątna główna, 7 anty-przekątna
+#define BB_SYMMETRIES 8
+extern int bbSymCell[BB_SYMMETRIES][BB_CELLS];     // Pole po transformacji
+extern int bbSymInverse[BB_SYMMETRIES][BB_CELLS];  // Transformacja odwrotna
+extern uint32_t bbSymByte[BB_SYMMETRIES][4][256];  // Transformacja maski po bajtach (bity 0-7, 8-15, 16-23, 24)
+
+// Losowe klucze Zobrista dla (gracz, pole) oraz ich wersje dla każdej orientacji:
+// zobristSym[t][gracz][pole] = zobristKeys[gracz][bbSymCell[t][pole]]
+extern uint64_t zobristKeys[3][BB_CELLS];
+extern uint64_t zobristSym[BB_SYMMETRIES][3][BB_CELLS];
+
+// Inicjalizacja masek wzorców (wywołać raz przy starcie programu)
+void initBitboards(void);
+
+// Pusta plansza (wszystkie linie mają kształt (0, 0))
+void bbClear(BitBoard* bb);
+
+// Konwersje z/do klasycznej planszy int[5][5]
+void bbFromBoard(BitBoard* bb, int src[5][5]);
+void bbToBoard(const BitBoard* bb, int dst[5][5]);
+
+// Generator liczb pseudolosowych (splitmix64) używany do kluczy Zobrista
+uint64_t bbRandom64(uint64_t* state);
+
+// === OPERACJE PODSTAWOWE (inline - używane w każdym węźle przeszukiwania) ===
+
+static inline int bbCellToMove(int cell) {
+    return (cell / 5 + 1) * 10 + (cell % 5 + 1);
+}
+
+static inline int bbMoveToCell(int move) {
+    return ((move / 10) - 1) * 5 + ((move % 10) - 1);
+}
+
+static inline uint32_t bbEmpty(const BitBoard* bb) {
+    return ~(bb->stones[1] | bb->stones[2]) & BB_FULL;
+}
+
+static inline int bbCellOwner(const BitBoard* bb, int cell) {
+    if (bb->stones[1] & (1u << cell)) return 1;
+    if (bb->stones[2] & (1u << cell)) return 2;
+    return 0;
+}
+
+// Zmiana kodów i kształtów linii przez pole o 'delta' cyfr (+gracz przy postawieniu, -gracz przy zdjęciu)
+static inline void bbUpdateLines(BitBoard* bb, int cell, int delta) {
+    for (int i = 0; i < cellWinCount[cell]; i++) {
+        int line = cellWinLine[cell][i];
+        int code = bb->winCodes[line];
+        int next = code + delta * cellWinDigit[cell][i];
+        bb->winCodes[line] = next;
+        bb->winShapes[winCodeShape[code]]--;
+        bb->winShapes[winCodeShape[next]]++;
+    }
+    for (int i = 0; i < cellLoseCount[cell]; i++) {
+        int line = cellLoseLine[cell][i];
+        int code = bb->loseCodes[line];
+        int next = code + delta * cellLoseDigit[cell][i];
+        bb->loseCodes[line] = next;
+        bb->loseShapes[loseCodeShape[code]]--;
+        bb->loseShapes[loseCodeShape[next]]++;
+    }
+}
+
+static inline void bbPlace(BitBoard* bb, int cell, int player) {
+    bb->stones[player] |= 1u << cell;
+    for (int t = 0; t < BB_SYMMETRIES; t++) {
+        bb->hash[t] ^= zobristSym[t][player][cell];
+    }
+    bbUpdateLines(bb, cell, player);
+}
+
+static inline void bbRemove(BitBoard* bb, int cell, int player) {
+    bb->stones[player] &= ~(1u << cell);
+    for (int t = 0; t < BB_SYMMETRIES; t++) {
+        bb->hash[t] ^= zobristSym[t][player][cell];
+    }
+    bbUpdateLines(bb, cell, -player);
+}
+
+// Klucz kanoniczny: najmniejszy z 8 kluczy orientacji - wspólny dla wszystkich
+// symetrycznych pozycji. *orientation = transformacja prowadząca do formy kanonicznej.
+static inline uint64_t bbCanonicalHash(const BitBoard* bb, int* orientation) {
+    uint64_t best = bb->hash[0];
+    int bestT = 0;
+    for (int t = 1; t < BB_SYMMETRIES; t++) {
+        if (bb->hash[t] < best) {
+            best = bb->hash[t];
+            bestT = t;
+        }
+    }
+    *orientation = bestT;
+    return best;
+}
+
+// Maska kamieni po transformacji t - cztery odczyty z tablicy zamiast 25 przesunięć bitów
+static inline uint32_t bbTransformMask(int t, uint32_t mask) {
+    return bbSymByte[t][0][mask & 0xFF] | bbSymByte[t][1][(mask >> 8) & 0xFF] |
+           bbSymByte[t][2][(mask >> 16) & 0xFF] | bbSymByte[t][3][(mask >> 24) & 0xFF];
+}
+
+// Kod pozycji odwracalny (bez kolizji): kamienie gracza na ruchu | kamienie przeciwnika << 25.
+// Kod kanoniczny to najmniejszy z 8 kodów orientacji - wspólny dla symetrycznych pozycji.
+static inline uint64_t bbPositionCode(uint32_t mover, uint32_t other) {
+    return (uint64_t)mover | ((uint64_t)other << BB_CELLS);
+}
+
+// *orientation = transformacja prowadząca do formy kanonicznej (jak w bbCanonicalHash)
+static inline uint64_t bbCanonicalCodeOriented(const BitBoard* bb, int toMove, int* orientation) {
+    uint32_t mover = bb->stones[toMove], other = bb->stones[3 - toMove];
+    uint64_t best = bbPositionCode(mover, other);
+    int bestT = 0;
+    for (int t = 1; t < BB_SYMMETRIES; t++) {
+        uint64_t code = bbPositionCode(bbTransformMask(t, mover), bbTransformMask(t, other));
+        if (code < best) {
+            best = code;
+            bestT = t;
+        }
+    }
+    *orientation = bestT;
+    return best;
+}
+
+static inline uint64_t bbCanonicalCode(const BitBoard* bb, int toMove) {
+    int orientation;
+    return bbCanonicalCodeOriented(bb, toMove, &orientation);
+}
+
+// 28 porównań AND zamiast przechodzenia po współrzędnych z tablicy win
+static inline bool bbWinCheck(const BitBoard* bb, int player) {
+    uint32_t s = bb->stones[player];
+    for (int i = 0; i < BB_WIN_PATTERNS; i++) {
+        if ((s & winMasks[i]) == winMasks[i]) return true;
+    }
+    return false;
+}
+
+// 48 porównań AND zamiast przechodzenia po współrzędnych z tablicy lose
+static inline bool bbLoseCheck(const BitBoard* bb, int player) {
+    uint32_t s = bb->stones[player];
+    for (int i = 0; i < BB_LOSE_PATTERNS; i++) {
+        if ((s & loseMasks[i]) == loseMasks[i]) return true;
+    }
+    return false;
+}
+
+// Sprawdzenie wygranej tylko na liniach przez ostatnio postawiony kamień (3-8 linii)
+static inline bool bbWinAt(const BitBoard* bb, int player, int cell) {
+    uint32_t s = bb->stones[player];
+    for (int i = 0; i < cellWinCount[cell]; i++) {
+        if ((s & cellWinMasks[cell][i]) == cellWinMasks[cell][i]) return true;
+    }
+    return false;
+}
+
+// Sprawdzenie przegranej tylko na liniach przez ostatnio postawiony kamień (3-12 linii)
+static inline bool bbLoseAt(const BitBoard* bb, int player, int cell) {
+    uint32_t s = bb->stones[player];
+    for (int i = 0; i < cellLoseCount[cell]; i++) {
+        if ((s & cellLoseMasks[cell][i]) == cellLoseMasks[cell][i]) return true;
+    }
+    return false;
+}
+
+// Czy postawienie kamienia na pustym polu dałoby wygraną/przegraną (bez zmiany pozycji)
+static inline bool bbWouldWin(const BitBoard* bb, int player, int cell) {
+    uint32_t s = bb->stones[player] | (1u << cell);
+    for (int i = 0; i < cellWinCount[cell]; i++) {
+        if ((s & cellWinMasks[cell][i]) == cellWinMasks[cell][i]) return true;
+    }
+    return false;
+}
+
+static inline bool bbWouldLose(const BitBoard* bb, int player, int cell) {
+    uint32_t s = bb->stones[player] | (1u << cell);
+    for (int i = 0; i < cellLoseCount[cell]; i++) {
+        if ((s & cellLoseMasks[cell][i]) == cellLoseMasks[cell][i]) return true;
+    }
+    return false;
+}
+
+#endif // BITBOARD_H
@@ -0,0 +1,132 @@
+#include "endgame.h"
+#include "search.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Klucze strony na ruchu (pozycja nie wyznacza jednoznacznie, kto zaczynał grę)
+static const uint64_t egTurnKeys[3] = { 0, 0x3C6EF372FE94F82Bull, 0xA54FF53A5F1D36F1ull };
+
+#define EG_BOUND_EXACT 0
+#define EG_BOUND_LOWER 1
+#define EG_BOUND_UPPER 2
+
+// === ZARZĄDZANIE PAMIĘCIĄ ===
+
+bool egInit(EndgameCache* cache, size_t sizeMB) {
+    if (sizeMB == 0) sizeMB = 1;
+
+    size_t maxEntries = (sizeMB << 20) / sizeof(uint64_t);
+    size_t count = 1;
+    while (count * 2 <= maxEntries) count *= 2;
+
+    cache->entries = calloc(count, sizeof(uint64_t));
+    if (!cache->entries) {
+        printf("Error: Cannot allocate %zu MB for endgame cache!\n", sizeMB);
+        cache->mask = 0;
+        return false;
+    }
+    cache->mask = count - 1;
+    return true;
+}
+
+void egClear(EndgameCache* cache) {
+    if (cache->entries) {
+        memset(cache->entries, 0, (cache->mask + 1) * sizeof(uint64_t));
+    }
+}
+
+void egFree(EndgameCache* cache) {
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->mask = 0;
+}
+
+// Wpis jest jednym słowem, więc czytanie i pisanie bez blokad jest bezpieczne między wątkami
+static inline bool egProbe(const EndgameCache* cache, uint64_t key, int* value, int* bound) {
+    uint64_t word = __atomic_load_n(&cache->entries[key & cache->mask], __ATOMIC_RELAXED);
+    if (word == 0 || ((word ^ key) & ~0xFull) != 0) return false;
+    *value = (int)(word & 0x3) - 1;
+    *bound = (int)((word >> 2) & 0x3);
+    return true;
+}
+
+static inline void egStore(EndgameCache* cache, uint64_t key, int value, int bound) {
+    uint64_t word = (key & ~0xFull) | ((uint64_t)bound << 2) | (uint64_t)(value + 1);
+    __atomic_store_n(&cache->entries[key & cache->mask], word, __ATOMIC_RELAXED);
+}
+
+// === SOLVER ===
+
+// Negamax na wartościach {-1, 0, 1} z przycinaniem alfa-beta. Pełna plansza to remis,
+// brak ruchu niesamobójczego to przegrana, 4 w rzędzie kończy grę przed sprawdzeniem 3 w rzędzie.
+static int solveNode(SearchContext* ctx, int toMove, int alpha, int beta) {
+    if ((++ctx->stats.nodes & 1023) == 0) searchPollStop(ctx);
+    if (ctx->aborted) return EG_DRAW;
+
+    BitBoard* bb = &ctx->board;
+    int opponent = 3 - toMove;
+    uint32_t empty = bbEmpty(bb);
+    if (!empty) return EG_DRAW;
+
+    // Tablica końcówek zawiera dokładnie te wartości, które policzyłby solver
+    int tbValue;
+    if (tbProbe(ctx->tablebase, bb, toMove, &tbValue)) return tbValue;
+
+    // Natychmiastowa wygrana, pola wygranej przeciwnika i ruchy samobójcze
+    uint32_t threats = 0, safe = 0;
+    for (uint32_t e = empty; e; e &= e - 1) {
+        int cell = __builtin_ctz(e);
+        if (bbWouldWin(bb, toMove, cell)) return EG_WIN;
+        if (bbWouldWin(bb, opponent, cell)) threats |= 1u << cell;
+        if (!bbWouldLose(bb, toMove, cell)) safe |= 1u << cell;
+    }
+    // Dwa zagrożenia przeciwnika nie do zablokowania jednym ruchem; jedno wymusza blokadę
+    if (__builtin_popcount(threats) >= 2) return EG_LOSS;
+    if (threats) safe &= threats;
+    if (!safe) return EG_LOSS;
+
+    EndgameCache* cache = ctx->endgame;
+    int alphaOrig = alpha;
+    uint64_t key = 0;
+    if (cache) {
+        int orientation, value, bound;
+        key = bbCanonicalHash(bb, &orientation) ^ egTurnKeys[toMove];
+        if (egProbe(cache, key, &value, &bound)) {
+            if (bound == EG_BOUND_EXACT) return value;
+            if (bound == EG_BOUND_LOWER && value > alpha) alpha = value;
+            if (bound == EG_BOUND_UPPER && value < beta) beta = value;
+            if (alpha >= beta) return value;
+        }
+    }
+
+    int best = EG_LOSS;
+    for (uint32_t s = safe; s; s &= s - 1) {
+        int cell = __builtin_ctz(s);
+        bbPlace(bb, cell, toMove);
+        int value = -solveNode(ctx, opponent, -beta, -alpha);
+        bbRemove(bb, cell, toMove);
+        if (ctx->aborted) return EG_DRAW;
+        if (value > best) best = value;
+        if (best > alpha) alpha = best;
+        if (alpha >= beta) break;
+    }
+
+    if (cache) {
+        int bound = EG_BOUND_EXACT;
+        if (best <= alphaOrig) bound = EG_BOUND_UPPER;
+        else if (best >= beta) bound = EG_BOUND_LOWER;
+        egStore(cache, key, best, bound);
+    }
+    return best;
+}
+
+int egSolve(SearchContext* ctx, int toMove) {
+    const BitBoard* bb = &ctx->board;
+    // Pozycja już rozstrzygnięta (4 w rzędzie wygrywa przed 3 w rzędzie)
+    if (bbWinCheck(bb, toMove)) return EG_WIN;
+    if (bbWinCheck(bb, 3 - toMove)) return EG_LOSS;
+    if (bbLoseCheck(bb, toMove)) return EG_LOSS;
+    if (bbLoseCheck(bb, 3 - toMove)) return EG_WIN;
+    return solveNode(ctx, toMove, EG_LOSS, EG_WIN);
+}
@@ -0,0 +1,35 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bitboard.h"
+
+#define EG_DEFAULT_EMPTY 14   // Rozwiązuj dokładnie pozycje z co najwyżej tyloma pustymi polami
+#define EG_DEFAULT_MB 16
+
+// Wartość teoriogrowa z perspektywy gracza na ruchu
+#define EG_LOSS -1
+#define EG_DRAW 0
+#define EG_WIN 1
+
+// Pamięć rozwiązanych pozycji: jedno słowo 64-bitowe na wpis -
+// klucz (bez 4 najmłodszych bitów) | typ ograniczenia (2 bity) | wartość + 1 (2 bity).
+// Wartości są dokładne, więc pamięć może być zachowana między ruchami i grami.
+typedef struct {
+    uint64_t* entries;
+    uint64_t mask;
+} EndgameCache;
+
+bool egInit(EndgameCache* cache, size_t sizeMB);
+void egClear(EndgameCache* cache);
+void egFree(EndgameCache* cache);
+
+// Dokładne rozwiązanie pozycji ctx->board dla gracza 'toMove' (EG_WIN / EG_DRAW / EG_LOSS).
+// Używa ctx->endgame (może być NULL), licznika węzłów, limitu czasu i flagi zatrzymania kontekstu -
+// po przerwaniu ctx->aborted == true, a wynik należy odrzucić.
+struct SearchContext;
+int egSolve(struct SearchContext* ctx, int toMove);
+
+#endif // ENDGAME_H
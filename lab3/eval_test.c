@@ -0,0 +1,391 @@
+#include "board.h"
+#include "bitboard.h"
+#include "endgame.h"
+#include "heuristic.h"
+#include "search.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Testy różnicowe silnika: evaluateBitboard porównywany z pierwotną funkcją oceny
+// na losowych pozycjach, stan przyrostowy BitBoard z bbFromBoard, solver końcówek z pełnym
+// przeszukiwaniem bez przycinania. Uruchomienie: make test
+
+#define EVAL_TEST_POSITIONS 200000
+#define EVAL_TEST_WALKS 2000
+#define EVAL_TEST_WALK_STEPS 100
+#define EG_TEST_MIN_EMPTY 2
+#define EG_TEST_MAX_EMPTY 10
+
+// === OCENA REFERENCYJNA ===
+
+// Pierwotna funkcja oceny na globalnej planszy (przed przejściem na bitboardy) - bez zmian,
+// żeby każda zmiana heurystyki lub bitboardów była porównywana z tym samym wzorcem
+static int referenceEvaluate(int who) {
+    int score = 0;
+    int opponent = 3 - who;
+    
+    // 0. ANALIZA STANU GRY: Policz puste pola (końcówka)
+    int empty_fields = 0;
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            if (board[i][j] == 0) empty_fields++;
+        }
+    }
+    bool is_endgame = (empty_fields <= 8);  // Końcówka gdy ≤8 pustych pól
+    
+    // 1. NAJWYŻSZA WAGA: Natychmiastowa wygrana (+10000)
+    if (winCheck(who)) return 10000;
+    if (winCheck(opponent)) return -10000;
+    
+    // 2. NAJWYŻSZA WAGA: Natychmiastowa przegrana (-10000)
+    if (loseCheck(who)) return -10000;
+    if (loseCheck(opponent)) return 10000;
+    
+    // 3. BARDZO WYSOKA WAGA: Sprawdź możliwości wygranej w następnym ruchu
+    int my_win_threats = 0;
+    int opp_win_threats = 0;
+    int my_forced_losses = 0;  // Sytuacje gdzie mogę być zmuszony do 3 w rzędzie
+    int opp_forced_losses = 0; // Sytuacje gdzie przeciwnik może być zmuszony
+    
+    // Sprawdź wszystkie wzorce 4 w rzędzie
+    for (int i = 0; i < 28; i++) {
+        int my_count = 0, opp_count = 0, empty_count = 0;
+        for (int j = 0; j < 4; j++) {
+            int row = win[i][j][0];
+            int col = win[i][j][1];
+            if (board[row][col] == who) my_count++;
+            else if (board[row][col] == opponent) opp_count++;
+            else empty_count++;
+        }
+        
+        // Sprawdź zagrożenia wygranej (3 moje + 1 puste)
+        if (my_count == 3 && empty_count == 1 && opp_count == 0) {
+            my_win_threats++;
+            score += 5000;  // Mogę wygrać w następnym ruchu
+        }
+        
+        // Sprawdź zagrożenia przeciwnika (3 jego + 1 puste)
+        if (opp_count == 3 && empty_count == 1 && my_count == 0) {
+            opp_win_threats++;
+            score -= 3000;  // Muszę blokować
+        }
+        
+        // ANALIZA PRZYMUSU: Sprawdź czy ktoś będzie zmuszony do ruchu
+        if (my_count == 2 && empty_count == 1 && opp_count == 1) {
+            // Mam 2, przeciwnik zablokował 1 pozycję, zostaje mi 1 opcja
+            if (is_endgame) {
+                my_forced_losses++; // W końcówce mogę być zmuszony do złego ruchu
+                score -= 400;
+            } else {
+                score -= 100; // W mid-game mniej groźne
+            }
+        }
+        
+        if (opp_count == 2 && empty_count == 1 && my_count == 1) {
+            // Przeciwnik ma 2, ja zablokowałem 1, zostaje mu 1 opcja
+            if (is_endgame) {
+                opp_forced_losses++; // Przeciwnik może być zmuszony
+                score += 300;
+            } else {
+                score += 80;
+            }
+        }
+        
+        // Sprawdź budowanie pozycji (2 + 2 puste)
+        if (my_count == 2 && empty_count == 2 && opp_count == 0) {
+            if (is_endgame) {
+                score += 150;  // W końcówce mniej agresywnie
+            } else {
+                score += 200;  // W mid-game buduj pozycję
+            }
+        }
+        if (opp_count == 2 && empty_count == 2 && my_count == 0) {
+            score -= 100;   // Przeciwnik buduje pozycję
+        }
+    }
+    
+    // 4. BARDZO WYSOKA WAGA: Wykryj widełki (2+ zagrożenia jednocześnie)
+    if (my_win_threats >= 2) {
+        score += 9999;  // WIDEŁKI! Nie do obrony
+    }
+    if (opp_win_threats >= 2) {
+        score -= 9998;  // Przeciwnik ma widełki - prawdopodobnie przegraliśmy
+    }
+    
+    // 5. KOŃCÓWKA: Analiza parity (kto gra ostatni)
+    if (is_endgame) {
+        bool i_play_last = (empty_fields % 2 == 1); // Jeśli nieparzysta liczba pól = ja gram ostatni
+        
+        if (my_forced_losses > opp_forced_losses) {
+            if (i_play_last) {
+                score -= 500; // Ja mam więcej pułapek I gram ostatni = źle
+            } else {
+                score -= 200; // Ja mam więcej pułapek ale przeciwnik gra ostatni
+            }
+        } else if (opp_forced_losses > my_forced_losses) {
+            if (!i_play_last) {
+                score += 400; // Przeciwnik ma więcej pułapek I gra ostatni = dobrze
+            } else {
+                score += 150; // Przeciwnik ma więcej pułapek ale ja gram ostatni
+            }
+        }
+    }
+    
+    // 5. ŚREDNIA WAGA: Sprawdź niebezpieczne wzorce 3 w rzędzie
+    for (int i = 0; i < 48; i++) {
+        int my_count = 0, opp_count = 0;
+        for (int j = 0; j < 3; j++) {
+            int row = lose[i][j][0];
+            int col = lose[i][j][1];
+            if (board[row][col] == who) my_count++;
+            else if (board[row][col] == opponent) opp_count++;
+        }
+        
+        // Sprawdź ryzyko 3 w rzędzie
+        if (my_count == 2) score -= 150;    // Ryzyko stworzenia 3 w rzędzie
+        if (opp_count == 2) score += 100;   // Przeciwnik w ryzyku
+    }
+    
+    // 6. NISKA WAGA: Analiza wzorców rozwoju (kontrola opcji)
+    for (int i = 0; i < 28; i++) {
+        int my_count = 0, opp_count = 0, empty_count = 0;
+        for (int j = 0; j < 4; j++) {
+            int row = win[i][j][0];
+            int col = win[i][j][1];
+            if (board[row][col] == who) my_count++;
+            else if (board[row][col] == opponent) opp_count++;
+            else empty_count++;
+        }
+        
+        // Analiza moich wzorców rozwoju
+        if (my_count == 2 && opp_count == 0) {
+            if (empty_count >= 2) {
+                score += 50;  // Bezpieczny wzorzec - mam wybór opcji
+            } else if (empty_count == 1) {
+                score -= 30;  // Niebezpieczny - tylko jedna opcja (ryzyko XXX)
+            }
+        }
+        
+        if (my_count == 1 && opp_count == 0 && empty_count == 3) {
+            score += 15;  // Dobry start - dużo opcji rozwoju
+        }
+        
+        // Analiza wzorców przeciwnika (blokowanie jego opcji)
+        if (opp_count == 2 && my_count == 0) {
+            if (empty_count >= 2) {
+                score -= 40;  // Przeciwnik ma bezpieczny wzorzec
+            } else if (empty_count == 1) {
+                score += 20;  // Przeciwnik w pułapce - tylko jedna opcja
+            }
+        }
+        
+        if (opp_count == 1 && my_count == 0 && empty_count == 3) {
+            score -= 10;  // Przeciwnik ma dobre opcje rozwoju
+        }
+        
+        // Premiuj dzielenie linii przeciwnika (blokowanie)
+        if (opp_count >= 1 && my_count >= 1) {
+            score += 25;  // Podzieliłem jego linię
+        }
+    }
+    
+    // 7. BARDZO NISKA WAGA: Kontrola centrum planszy
+    if (board[2][2] == who) score += 25;
+    if (board[2][2] == opponent) score -= 20;
+    
+    // Sprawdź pola obok centrum
+    int center_positions[][2] = {{1,1}, {1,2}, {1,3}, {2,1}, {2,3}, {3,1}, {3,2}, {3,3}};
+    for (int i = 0; i < 8; i++) {
+        int row = center_positions[i][0];
+        int col = center_positions[i][1];
+        if (board[row][col] == who) score += 5;
+        if (board[row][col] == opponent) score -= 3;
+    }
+    
+    return score;
+}
+
+// === POZYCJE LOSOWE ===
+
+// Losowa plansza: każde pole puste, gracza 1 lub 2 (także pozycje rozstrzygnięte
+// i nieosiągalne w grze - ocena ma się zgadzać na dowolnej planszy)
+static void randomBoard(uint64_t* seed) {
+    uint64_t r = bbRandom64(seed);
+    int emptyPercent = (int)(r % 101);
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 5; j++) {
+            r = bbRandom64(seed);
+            if ((int)(r % 100) < emptyPercent) board[i][j] = 0;
+            else board[i][j] = 1 + (int)((r >> 32) & 1);
+        }
+    }
+}
+
+// === TESTY ===
+
+static int testEvaluation(void) {
+    uint64_t seed = 0xE7A1ull;
+    int failures = 0;
+    for (int n = 0; n < EVAL_TEST_POSITIONS; n++) {
+        randomBoard(&seed);
+        BitBoard bb;
+        bbFromBoard(&bb, board);
+        for (int who = 1; who <= 2; who++) {
+            int expected = referenceEvaluate(who);
+            int actual = evaluateBitboard(&bb, who);
+            if (actual != expected && failures++ < 5) {
+                printf("evaluateBitboard(who=%d) = %d, expected %d\n", who, actual, expected);
+                printBoard();
+            }
+        }
+    }
+    printf("%-40s %s (%d positions)\n", "evaluateBitboard == evaluateBoard", failures ? "FAIL" : "ok",
+           EVAL_TEST_POSITIONS);
+    return failures;
+}
+
+// Czy stan utrzymywany przez bbPlace/bbRemove jest taki sam jak zbudowany od zera
+static bool sameBitboard(const BitBoard* a, const BitBoard* b) {
+    return a->stones[1] == b->stones[1] && a->stones[2] == b->stones[2] &&
+           memcmp(a->hash, b->hash, sizeof(a->hash)) == 0 &&
+           memcmp(a->winCodes, b->winCodes, sizeof(a->winCodes)) == 0 &&
+           memcmp(a->loseCodes, b->loseCodes, sizeof(a->loseCodes)) == 0 &&
+           memcmp(a->winShapes, b->winShapes, sizeof(a->winShapes)) == 0 &&
+           memcmp(a->loseShapes, b->loseShapes, sizeof(a->loseShapes)) == 0;
+}
+
+// Losowe ciągi bbPlace/bbRemove: po każdym kroku kody linii, liczniki kształtów i klucze
+// muszą być równe stanowi z bbFromBoard, a ocena - ocenie referencyjnej
+static int testIncremental(void) {
+    uint64_t seed = 0x1C2Eull;
+    int failures = 0;
+    long long steps = 0;
+    for (int walk = 0; walk < EVAL_TEST_WALKS; walk++) {
+        BitBoard bb;
+        bbClear(&bb);
+        setBoard();
+        for (int step = 0; step < EVAL_TEST_WALK_STEPS; step++, steps++) {
+            uint64_t r = bbRandom64(&seed);
+            int cell = (int)(r % BB_CELLS);
+            int owner = board[cell / 5][cell % 5];
+            if (owner) {
+                bbRemove(&bb, cell, owner);
+                board[cell / 5][cell % 5] = 0;
+            } else {
+                int player = 1 + (int)((r >> 32) & 1);
+                bbPlace(&bb, cell, player);
+                board[cell / 5][cell % 5] = player;
+            }
+
+            BitBoard fresh;
+            bbFromBoard(&fresh, board);
+            bool ok = sameBitboard(&bb, &fresh);
+            for (int who = 1; who <= 2; who++) {
+                if (evaluateBitboard(&bb, who) != referenceEvaluate(who)) ok = false;
+            }
+            if (!ok && failures++ < 5) {
+                printf("Incremental state differs from bbFromBoard after %s %d\n", owner ? "bbRemove" : "bbPlace",
+                       bbCellToMove(cell));
+                printBoard();
+            }
+        }
+    }
+    printf("%-40s %s (%lld steps)\n", "bbPlace/bbRemove == bbFromBoard", failures ? "FAIL" : "ok", steps);
+    return failures;
+}
+
+// === SOLVER KOŃCÓWEK ===
+
+// Wartość pozycji pełnym przeszukiwaniem (bez przycinania, pamięci i skrótów solvera):
+// 4 w rzędzie wygrywa przed 3 w rzędzie, pełna plansza to remis
+static int bruteForce(BitBoard* bb, int toMove) {
+    uint32_t empty = bbEmpty(bb);
+    if (!empty) return EG_DRAW;
+    int best = EG_LOSS;
+    for (uint32_t e = empty; e && best != EG_WIN; e &= e - 1) {
+        int cell = __builtin_ctz(e);
+        bbPlace(bb, cell, toMove);
+        int value;
+        if (bbWinAt(bb, toMove, cell)) value = EG_WIN;
+        else if (bbLoseAt(bb, toMove, cell)) value = EG_LOSS;
+        else value = -bruteForce(bb, 3 - toMove);
+        bbRemove(bb, cell, toMove);
+        if (value > best) best = value;
+    }
+    return best;
+}
+
+// Losowa nierozstrzygnięta pozycja z 'empty' pustymi polami (partia losowych ruchów
+// niekończących gry); zwraca gracza na ruchu albo 0, gdy partia utknęła wcześniej
+static int randomUndecided(BitBoard* bb, int empty, uint64_t* seed) {
+    bbClear(bb);
+    int toMove = 1;
+    for (int placed = 0; placed < BB_CELLS - empty; placed++) {
+        uint32_t quiet = 0;
+        for (uint32_t e = bbEmpty(bb); e; e &= e - 1) {
+            int cell = __builtin_ctz(e);
+            if (!bbWouldWin(bb, toMove, cell) && !bbWouldLose(bb, toMove, cell)) quiet |= 1u << cell;
+        }
+        if (!quiet) return 0;
+        int pick = (int)(bbRandom64(seed) % (uint64_t)__builtin_popcount(quiet));
+        while (pick--) quiet &= quiet - 1;
+        bbPlace(bb, __builtin_ctz(quiet), toMove);
+        toMove = 3 - toMove;
+    }
+    return toMove;
+}
+
+// egSolve (z pamięcią końcówek i bez niej) względem pełnego przeszukiwania dla 2-10 pustych pól
+static int testEndgameSolver(void) {
+    uint64_t seed = 0xE6501ull;
+    int failures = 0, positions = 0;
+    EndgameCache cache;
+    if (!egInit(&cache, 4)) return 1;
+
+    for (int empty = EG_TEST_MIN_EMPTY; empty <= EG_TEST_MAX_EMPTY; empty++) {
+        int count = (empty <= 8) ? 200 : 20;
+        for (int n = 0; n < count; n++) {
+            BitBoard bb;
+            int toMove;
+            while ((toMove = randomUndecided(&bb, empty, &seed)) == 0) {
+            }
+            int expected = bruteForce(&bb, toMove);
+
+            SearchContext ctx;
+            searchInit(&ctx, NULL);
+            searchSetPosition(&ctx, &bb);
+            int plain = egSolve(&ctx, toMove);
+            ctx.endgame = &cache;
+            int cached = egSolve(&ctx, toMove);
+            positions++;
+
+            if ((plain != expected || cached != expected) && failures++ < 5) {
+                printf("egSolve = %d (cache: %d), expected %d, player %d to move\n", plain, cached, expected, toMove);
+                bbToBoard(&bb, board);
+                printBoard();
+            }
+        }
+    }
+    egFree(&cache);
+    printf("%-40s %s (%d positions, %d-%d empty)\n", "egSolve == brute force", failures ? "FAIL" : "ok", positions,
+           EG_TEST_MIN_EMPTY, EG_TEST_MAX_EMPTY);
+    return failures;
+}
+
+int main(void) {
+    initBitboards();
+    initEvaluation();
+
+    int failures = 0;
+    failures += testEvaluation();
+    failures += testIncremental();
+    failures += testEndgameSolver();
+
+    if (failures) {
+        printf("FAILED: %d mismatches\n", failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}
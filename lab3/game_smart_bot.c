@@ -1,112 +1,363 @@
 #include "board.h"
+#include "bitboard.h"
+#include "endgame.h"
 #include "heuristic.h"
 #include "opening_book.h"
+#include "search.h"
+#include "tablebase.h"
+#include "transposition.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <arpa/inet.h>
+#include <errno.h>
+#include <sys/epoll.h>
 #include <stdbool.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 int player, opponent, searchDepth;
 bool learningMode = false;  // Tryb uczenia książki otwarć
 int gameMovesCount = 0;     // Licznik ruchów w grze
+TranspositionTable transTable;  // Tablica transpozycji przeszukiwania (rozmiar z --tt-mb)
+int timeLimitMs = 0;        // Limit czasu na ruch w ms (--time-ms, 0 = tylko limit głębokości)
+int searchThreads = 1;      // Liczba wątków przeszukiwania w grze (--threads, Lazy SMP)
+int solveEmpty = EG_DEFAULT_EMPTY;  // Dokładny solver od tylu pustych pól (--solve-empty, 0 = wyłączony)
+EndgameCache endgameCache;  // Pamięć solvera końcówek - wartości dokładne, zachowywana przez całą grę
+Tablebase tablebase = { .maxEmpty = -1 };  // Tablica końcówek z pliku (--tb-file), mmap przy starcie
+bool ponderEnabled = false; // Przeszukiwanie w czasie przeciwnika (--ponder)
+PonderResult ponderResult;  // Nasze odpowiedzi policzone w czasie przeciwnika
+bool ponderReady = false;   // ponderResult dotyczy pozycji przed ostatnim ruchem przeciwnika
+int lastOpponentMove = 0;   // Ostatni ruch przeciwnika (0 = brak)
+SearchContext gameContext;  // Kontekst przeszukiwania całej gry (killery, historia, tablica transpozycji)
+int multiGames = 0;         // Liczba równoczesnych gier w jednym procesie (--games, 0 = jedna gra)
+int multiWorkers = 0;       // Wątki robocze przeszukiwania w trybie wielu gier (--workers, 0 = liczba rdzeni)
 
 // Funkcja bestMove: wybiera najlepszy ruch na podstawie heurystyki i minimax
 int bestMove() {
-    // KROK 1: Sprawdź książkę otwarć (tylko w pierwszych 10 ruchach)
-    char* currentSequence = buildMoveSequence();
-    
-    printf("[DEBUG] bestMove called, gameMovesCount=%d, sequence='%s'\n", gameMovesCount, currentSequence);
-    
+    BitBoard bb;
+    bbFromBoard(&bb, board);
+
+    // KROK 1: Sprawdź książkę otwarć (tylko w pierwszych ruchach) - wyszukiwanie po pozycji
     if (isInOpeningPhase(gameMovesCount)) {
-        int openingMove = getOpeningMove(currentSequence, gameMovesCount);
-        printf("[DEBUG] Opening phase - checked book for '%s', got move: %d\n", currentSequence, openingMove);
+        int openingMove = getOpeningMove(&bb, player);
         if (openingMove != 0) {
-            printf("[OPENING BOOK] Using move %d from book for sequence: %s\n", openingMove, currentSequence);
             return openingMove;  // Użyj ruchu z książki
         }
-    } else {
-        printf("[DEBUG] Not in opening phase (move count: %d > %d)\n", gameMovesCount, MAX_OPENING_MOVES);
     }
     
-    // KROK 2: Standardowy minimax jeśli brak w książce
-    int bestScore = -100000;
-    int move = 0;
-    int safeMove = 0;
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (board[i][j] == 0) {
-                board[i][j] = player;
-                // Jeśli ten ruch daje natychmiastową wygraną, wybierz go od razu
-                if (winCheck(player)) {
-                    board[i][j] = 0;
-                    return (i + 1) * 10 + (j + 1);
-                }
-                // Jeśli ten ruch blokuje natychmiastową wygraną przeciwnika, zapamiętaj go
-                board[i][j] = 3 - player;
-                if (winCheck(3 - player)) {
-                    board[i][j] = 0;
-                    // wróć do swojego ruchu
-                    board[i][j] = player;
-                    move = (i + 1) * 10 + (j + 1);
-                    board[i][j] = 0;
-                    return move;
-                }
-                board[i][j] = player;
-                // Odrzuć ruch, jeśli natychmiast przegrywasz (3 w rzędzie)
-                if (loseCheck(player)) {
-                    board[i][j] = 0;
-                    continue; // Całkowicie odrzuć ten ruch - nie jest bezpieczny
-                }
-                // Ten ruch jest bezpieczny (nie powoduje natychmiastowej przegranej)
-                if (safeMove == 0) safeMove = (i + 1) * 10 + (j + 1);
-                int score = minimax(searchDepth - 1, -100000, 100000, 3 - player, false, player);
-                board[i][j] = 0;
-                if (score > bestScore) {
-                    bestScore = score;
-                    move = (i + 1) * 10 + (j + 1);
-                }
-            }
+    // KROK 2: Odpowiedź policzona w czasie przeciwnika (--ponder)
+    if (ponderReady && lastOpponentMove != 0) {
+        ponderReady = false;
+        int cell = bbMoveToCell(lastOpponentMove);
+        if (ponderResult.move[cell] != 0 && bbCellOwner(&bb, bbMoveToCell(ponderResult.move[cell])) == 0) {
+            printf("[PONDER] hit: reply %d -> move %d (depth %d, score %d)\n", lastOpponentMove,
+                   ponderResult.move[cell], ponderResult.depth[cell], ponderResult.score[cell]);
+            return ponderResult.move[cell];
         }
+        printf("[PONDER] miss: reply %d not searched (%d/%d replies done)\n", lastOpponentMove,
+               ponderResult.searched, ponderResult.replies);
+    }
+    
+    // KROK 3: Przeszukiwanie jeśli brak w książce - ten sam silnik co w uczeniu książki.
+    // Kontekst żyje przez całą grę: tablica transpozycji dostaje nową generację zamiast czyszczenia
+    // (poddrzewo pod faktyczną odpowiedzią przeciwnika zostaje), killery i historia przechodzą dalej.
+    ttNewSearch(&transTable);
+    searchSetPosition(&gameContext, &bb);
+    SearchLimits limits = { searchDepth, timeLimitMs, searchThreads, solveEmpty, true, true };
+    SearchResult result = searchBestMove(&gameContext, player, &limits);
+    if (result.nodes > 0) {
+        ttPrintStats(&transTable);
+    }
+    return result.move;
+}
+
+// Odbiór wiadomości serwera. Z --ponder w tym czasie drugi wątek przeszukuje odpowiedzi przeciwnika
+// na nasz ostatni ruch, aż wiadomość nadejdzie.
+ssize_t receiveMessage(int server_socket, char* server_message, size_t size, bool ponder) {
+  if (!ponder) {
+    return recv(server_socket, server_message, size, 0);
+  }
+  ssize_t received = 0;
+  atomic_bool stop = false;
+  BitBoard bb;
+  bbFromBoard(&bb, board);
+#ifdef _OPENMP
+  #pragma omp parallel sections num_threads(2)
+#endif
+  {
+#ifdef _OPENMP
+    #pragma omp section
+#endif
+    {
+      received = recv(server_socket, server_message, size, 0);
+      atomic_store(&stop, true);
+    }
+#ifdef _OPENMP
+    #pragma omp section
+#endif
+    {
+      ttNewSearch(&transTable);  // Wpisy z czasu przeciwnika świeższe niż z naszego ostatniego ruchu
+      SearchContext ctx;
+      searchInit(&ctx, &transTable);
+      ctx.endgame = (solveEmpty > 0) ? &endgameCache : NULL;
+      ctx.tablebase = (tablebase.map != NULL) ? &tablebase : NULL;
+      ctx.stop = &stop;
+      searchSetPosition(&ctx, &bb);
+      SearchLimits limits = { searchDepth, 0, searchThreads, solveEmpty, false, false };
+      searchPonder(&ctx, player, &limits, &ponderResult);
+      searchFlushStats(&ctx);
     }
-    // Jeśli nie znaleziono żadnego "bezpiecznego" ruchu, wybierz pierwszy niebezpieczny
-    if (move == 0 && safeMove != 0) {
-        return safeMove;
-    }
-    // Jeśli nie ma lepszego ruchu, wybierz wolne pole najbliżej środka planszy
-    if (move == 0) {
-        int bestDist = 100;
-        int bestI = -1, bestJ = -1;
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 5; j++) {
-                if (board[i][j] == 0) {
-                    int dist = (i - 2) * (i - 2) + (j - 2) * (j - 2);
-                    if (dist < bestDist) {
-                        bestDist = dist;
-                        bestI = i;
-                        bestJ = j;
-                    }
-                }
-            }
+  }
+  ponderReady = true;
+  printf("[PONDER] searched %d/%d opponent replies (%lld nodes)\n", ponderResult.searched,
+         ponderResult.replies, ponderResult.nodes);
+  return received;
+}
+
+// Połączenie z serwerem: powitanie serwera, potem "<id> <nazwa>". Zwraca gniazdo albo -1.
+int connectToServer(const char* ip, int port, const char* playerId, const char* name, bool verbose) {
+  char server_message[16], player_message[16];
+  struct sockaddr_in server_addr;
+
+  // Create socket
+  int server_socket = socket(AF_INET, SOCK_STREAM, 0);
+  if ( server_socket < 0 ) {
+    printf("Unable to create socket\n");
+    return -1;
+  }
+  if (verbose) printf("Socket created successfully\n");
+
+  // Set port and IP the same as server-side
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(port);
+  server_addr.sin_addr.s_addr = inet_addr(ip);
+
+  // Send connection request to server
+  if ( connect(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0 ) {
+    printf("Unable to connect\n");
+    close(server_socket);
+    return -1;
+  }
+  if (verbose) printf("Connected with server successfully\n");
+
+  // Receive the server message
+  memset(server_message, '\0', sizeof(server_message));
+  if ( recv(server_socket, server_message, sizeof(server_message), 0) < 0 ) {
+    printf("Error while receiving server's message\n");
+    close(server_socket);
+    return -1;
+  }
+  memset(player_message, '\0', sizeof(player_message));
+  snprintf(player_message, sizeof(player_message), "%s %s", playerId, name);
+  // Send the message to server
+  if (send(server_socket, player_message, strlen(player_message), 0) < 0) {
+    printf("Unable to send message\n");
+    close(server_socket);
+    return -1;
+  }
+  return server_socket;
+}
+
+// === WIELE GIER W JEDNYM PROCESIE (--games) ===
+
+// Stan jednej gry. Plansza, licznik ruchów i kontekst przeszukiwania należą do gry,
+// a książka otwarć, tablica końcówek, pamięć solvera i tablica transpozycji są wspólne.
+typedef struct {
+  int socket;
+  int id;
+  BitBoard board;
+  int movesCount;
+  SearchContext ctx;          // Killery i historia tej gry
+  atomic_bool busy;           // Ruch liczony przez wątek roboczy - gra należy do zadania do wysłania ruchu
+  bool finished;
+  int result;                 // Kod końca gry z serwera (1-5)
+  int searches;
+  double searchMs;
+} GameSession;
+
+static double sessionNowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec * 1e-6;
+}
+
+// Przeszukiwania ze wszystkich gier. Wspólna tablica transpozycji dostaje nową generację co
+// multiGames przeszukiwań (mniej więcej raz na ruch każdej gry) - wpisy gier zakończonych
+// i poprzednich ruchów przestają być chronione przed nadpisaniem, jak przy ttNewSearch w jednej grze.
+static atomic_int sessionSearches;
+
+// Ruch w grze 'game' (wątek roboczy): książka otwarć, potem przeszukiwanie jak w bestMove()
+static int sessionMove(GameSession* game) {
+  int move = 0;
+  if (isInOpeningPhase(game->movesCount)) {
+    move = getOpeningMove(&game->board, player);
+  }
+  if (move == 0) {
+    double start = sessionNowMs();
+    if (atomic_fetch_add_explicit(&sessionSearches, 1, memory_order_relaxed) % multiGames == 0) {
+      ttAdvanceGeneration(&transTable);
+    }
+    searchSetPosition(&game->ctx, &game->board);
+    SearchLimits limits = { searchDepth, timeLimitMs, 1, solveEmpty, false, true };
+    SearchResult result = searchBestMove(&game->ctx, player, &limits);
+    move = result.move;
+    game->searches++;
+    game->searchMs += sessionNowMs() - start;
+  }
+  return move;
+}
+
+static void sessionPlay(GameSession* game) {
+  int move = sessionMove(game);
+  int cell = bbMoveToCell(move);
+  if (move != 0 && bbCellOwner(&game->board, cell) == 0) {
+    bbPlace(&game->board, cell, player);
+  }
+  game->movesCount++;
+  char player_message[16];
+  snprintf(player_message, sizeof(player_message), "%d", move);
+  // Zwolnienie gry przed wysłaniem: następna wiadomość tej gry może przyjść dopiero po ruchu
+  atomic_store_explicit(&game->busy, false, memory_order_release);
+  if (send(game->socket, player_message, strlen(player_message), 0) < 0) {
+    printf("[GAME %d] Unable to send message\n", game->id);
+  }
+}
+
+// Wiadomość serwera dla gry 'game' (pętla zdarzeń). Ruch do policzenia trafia do puli wątków jako zadanie.
+static void sessionMessage(GameSession* game, const char* server_message) {
+  int msg = 0, move;
+  sscanf(server_message, "%d", &msg);
+  move = msg % 100;
+  msg = msg / 100;
+  if (move != 0) {
+    int cell = bbMoveToCell(move);
+    if (move >= 11 && move <= 55 && bbCellOwner(&game->board, cell) == 0) {
+      bbPlace(&game->board, cell, 3 - player);
+    }
+    game->movesCount++;
+  }
+  if ((msg == 0) || (msg == 6)) {
+    atomic_store_explicit(&game->busy, true, memory_order_relaxed);
+#ifdef _OPENMP
+    #pragma omp task firstprivate(game)
+#endif
+    sessionPlay(game);
+  } else {
+    // Kody spoza 1-5 (uszkodzona wiadomość) liczone jak rozłączenie
+    game->finished = true;
+    game->result = (msg >= 1 && msg <= 5) ? msg : 0;
+  }
+}
+
+// Wątek główny obsługuje pętlę epoll, a pozostałe wątki zespołu OpenMP wykonują zadania przeszukiwania
+int playManyGames(const char* ip, int port, const char* playerId, const char* name) {
+  GameSession* games = calloc(multiGames, sizeof(GameSession));
+  int epollFd = epoll_create1(0);
+  if (!games || epollFd < 0) {
+    printf("Error: Cannot start %d games!\n", multiGames);
+    free(games);
+    return -1;
+  }
+  sscanf(playerId, "%d", &player);
+
+  int connected = 0;
+  for (int g = 0; g < multiGames; g++) {
+    GameSession* game = &games[g];
+    game->id = g;
+    game->socket = connectToServer(ip, port, playerId, name, false);
+    if (game->socket < 0) {
+      game->finished = true;
+      continue;
+    }
+    bbClear(&game->board);
+    searchInit(&game->ctx, &transTable);
+    game->ctx.endgame = (solveEmpty > 0) ? &endgameCache : NULL;
+    game->ctx.tablebase = (tablebase.map != NULL) ? &tablebase : NULL;
+    atomic_init(&game->busy, false);
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = game };
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, game->socket, &event);
+    connected++;
+  }
+  printf("Multi-game mode: %d/%d games connected, %d search workers\n", connected, multiGames, multiWorkers);
+
+  double start = sessionNowMs();
+  int active = connected;
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(multiWorkers + 1)
+  #pragma omp single
+#endif
+  {
+    struct epoll_event events[64];
+    while (active > 0) {
+      int ready = epoll_wait(epollFd, events, 64, -1);
+      if (ready < 0) {
+        if (errno == EINTR) continue;
+        printf("Error in epoll_wait\n");
+        break;
+      }
+      for (int i = 0; i < ready; i++) {
+        GameSession* game = events[i].data.ptr;
+        char server_message[16];
+        memset(server_message, '\0', sizeof(server_message));
+        ssize_t received = recv(game->socket, server_message, sizeof(server_message), 0);
+        // Gniazda są zamykane dopiero po zakończeniu wszystkich zadań (zadanie może jeszcze wysyłać)
+        if (received <= 0) {
+          printf("[GAME %d] Error while receiving server's message\n", game->id);
+          game->finished = true;
+          game->result = 0;
+        } else if (atomic_load_explicit(&game->busy, memory_order_acquire)) {
+          // Serwer odpowiada dopiero na wysłany ruch, więc wiadomość w trakcie przeszukiwania to błąd
+          // protokołu - plansza należy wtedy do zadania i nie może być zmieniana
+          printf("[GAME %d] Server message while our move is being searched - protocol error\n", game->id);
+          game->finished = true;
+          game->result = 0;
+        } else {
+          sessionMessage(game, server_message);  // Acquire powyżej: stan gry z zakończonego zadania
         }
-        if (bestI != -1 && bestJ != -1) {
-            return (bestI + 1) * 10 + (bestJ + 1);
+        if (game->finished) {
+          epoll_ctl(epollFd, EPOLL_CTL_DEL, game->socket, NULL);
+          active--;
         }
+      }
     }
-    return move;
+  }
+
+  // Podsumowanie wszystkich gier
+  int results[6] = {0};
+  int searches = 0;
+  double searchMs = 0.0;
+  for (int g = 0; g < multiGames; g++) {
+    if (games[g].socket >= 0) close(games[g].socket);
+    if (games[g].result >= 0 && games[g].result < 6) results[games[g].result]++;
+    searches += games[g].searches;
+    searchMs += games[g].searchMs;
+  }
+  close(epollFd);
+  printf("=== MULTI-GAME SUMMARY ===\n");
+  printf("Games: %d, won %d, lost %d, draw %d, won (opponent error) %d, lost (own error) %d, disconnected %d\n",
+         multiGames, results[1], results[2], results[3], results[4], results[5], results[0]);
+  printf("Searched moves: %d, avg %.2f ms per move, total %.1f s\n", searches,
+         searches > 0 ? searchMs / searches : 0.0, (sessionNowMs() - start) / 1000.0);
+  ttPrintStats(&transTable);
+  free(games);
+  return 0;
 }
 
 int main(int argc, char *argv[]) {
   int server_socket;
-  struct sockaddr_in server_addr;
   char server_message[16], player_message[16];
 
   bool end_game;
   int msg, move;
 
+  initBitboards();
+  initEvaluation();
+
   // OBSŁUGA TRYBU UCZENIA
   if (argc >= 2 && (strstr(argv[1], "--learn") != NULL || 
                     (argc > 1 && strstr(argv[1], "--learn-depth") != NULL))) {
@@ -115,6 +366,7 @@ int main(int argc, char *argv[]) {
     // Parsuj argumenty uczenia: --learn-depth=X-search=Y
     int learnDepth = 6;   // domyślnie
     int searchDepth = 6;  // domyślnie
+    bool resume = false;  // --resume: kontynuacja z punktu kontrolnego
     
     for (int i = 1; i < argc; i++) {
       if (strstr(argv[i], "--learn-depth=") != NULL) {
@@ -123,62 +375,170 @@ int main(int argc, char *argv[]) {
       if (strstr(argv[i], "--search-depth=") != NULL) {
         sscanf(argv[i], "--search-depth=%d", &searchDepth);
       }
+      if (strcmp(argv[i], "--resume") == 0) resume = true;
     }
     
     printf("Learning parameters: depth=%d, search=%d\n", learnDepth, searchDepth);
     
     // Inicjuj planszę
     setBoard();
-    clearMoveHistory();
     
     // Rozpocznij uczenie
-    learnOpenings(learnDepth, searchDepth, "opening_book_2.txt");
+    learnOpenings(learnDepth, searchDepth, "opening_book_2.txt", resume);
     
     // Zwolnij pamięć i zakończ
     freeOpeningBook();
     return 0;
   }
 
+  // PEŁNA KSIĄŻKA OTWARĆ: --book-full=N [--search-depth=Y] [--resume]
+  if (argc >= 2 && strstr(argv[1], "--book-full") != NULL) {
+    int plies = 4;
+    int searchDepth = 6;
+    bool resume = false;
+    for (int i = 1; i < argc; i++) {
+      if (strstr(argv[i], "--book-full=") != NULL) {
+        sscanf(argv[i], "--book-full=%d", &plies);
+      }
+      if (strstr(argv[i], "--search-depth=") != NULL) {
+        sscanf(argv[i], "--search-depth=%d", &searchDepth);
+      }
+      if (strcmp(argv[i], "--resume") == 0) resume = true;
+    }
+    generateFullBook(plies, searchDepth, "opening_book_2.txt", resume);
+    freeOpeningBook();
+    return 0;
+  }
+
+  // GENEROWANIE TABLICY KOŃCÓWEK: --tb-gen=K [--tb-file=plik]
+  if (argc >= 2 && strstr(argv[1], "--tb-gen") != NULL) {
+    int tbEmpty = TB_DEFAULT_EMPTY;
+    const char* tbFile = TB_DEFAULT_FILE;
+    for (int i = 1; i < argc; i++) {
+      if (strstr(argv[i], "--tb-gen=") != NULL) {
+        sscanf(argv[i], "--tb-gen=%d", &tbEmpty);
+      }
+      if (strstr(argv[i], "--tb-file=") != NULL) {
+        tbFile = argv[i] + strlen("--tb-file=");
+      }
+    }
+    return tbGenerate(tbEmpty, tbFile) ? 0 : -1;
+  }
+
+  // KONWERSJA KSIĄŻKI OTWARĆ: --book-convert[=plik.txt] -> plik.bin
+  if (argc >= 2 && strstr(argv[1], "--book-convert") != NULL) {
+    const char* textFile = "opening_book_2.txt";
+    if (strstr(argv[1], "--book-convert=") != NULL) {
+      textFile = argv[1] + strlen("--book-convert=");
+    }
+    bool converted = convertOpeningBook(textFile);
+    freeOpeningBook();
+    return converted ? 0 : -1;
+  }
+
+  // POMIAR KSIĄŻKI OTWARĆ: --bench-book[=N]
+  if (argc >= 2 && strstr(argv[1], "--bench-book") != NULL) {
+    int maxEntries = 1000000;
+    sscanf(argv[1], "--bench-book=%d", &maxEntries);
+    benchmarkOpeningBook(maxEntries);
+    return 0;
+  }
+
   // NORMALNY TRYB GRY
-  if (argc != 6) {
-    printf("Usage: %s <IP> <PORT> <PLAYER_ID> <n> <DEPTH>\n", argv[0]);
-    printf("   or: %s --learn-depth=X --search-depth=Y\n", argv[0]);
+  if (argc < 6) {
+    printf("Usage: %s <IP> <PORT> <PLAYER_ID> <n> <MAX_DEPTH> [--tt-mb=M] [--time-ms=T] [--threads=N] [--solve-empty=E] [--tb-file=F] [--ponder] [--games=G] [--workers=W]\n", argv[0]);
+    printf("   or: %s --learn-depth=X --search-depth=Y [--resume]\n", argv[0]);
+    printf("   or: %s --book-full=N [--search-depth=Y] [--resume]\n", argv[0]);
+    printf("   or: %s --tb-gen=K [--tb-file=F]\n", argv[0]);
+    printf("   or: %s --book-convert[=opening_book_2.txt]\n", argv[0]);
+    printf("   or: %s --bench-book[=N]\n", argv[0]);
     return -1;
   }
   
   searchDepth = atoi(argv[5]);
 
-  // Create socket
-  server_socket = socket(AF_INET, SOCK_STREAM, 0);
-  if ( server_socket < 0 ) {
-    printf("Unable to create socket\n");
+  // Opcjonalne parametry przeszukiwania
+  int ttMegabytes = TT_DEFAULT_MB;
+  const char* tbFile = TB_DEFAULT_FILE;
+  for (int i = 6; i < argc; i++) {
+    if (strstr(argv[i], "--tt-mb=") != NULL) {
+      sscanf(argv[i], "--tt-mb=%d", &ttMegabytes);
+    }
+    if (strstr(argv[i], "--time-ms=") != NULL) {
+      sscanf(argv[i], "--time-ms=%d", &timeLimitMs);
+    }
+    if (strstr(argv[i], "--threads=") != NULL) {
+      sscanf(argv[i], "--threads=%d", &searchThreads);
+    }
+    if (strstr(argv[i], "--solve-empty=") != NULL) {
+      sscanf(argv[i], "--solve-empty=%d", &solveEmpty);
+    }
+    if (strstr(argv[i], "--tb-file=") != NULL) {
+      tbFile = argv[i] + strlen("--tb-file=");
+    }
+    if (strcmp(argv[i], "--ponder") == 0) {
+      ponderEnabled = true;
+    }
+    if (strstr(argv[i], "--games=") != NULL) {
+      sscanf(argv[i], "--games=%d", &multiGames);
+    }
+    if (strstr(argv[i], "--workers=") != NULL) {
+      sscanf(argv[i], "--workers=%d", &multiWorkers);
+    }
+  }
+  if (searchThreads < 1) searchThreads = 1;
+  if (searchThreads > MAX_SEARCH_THREADS) searchThreads = MAX_SEARCH_THREADS;
+  if (multiGames > 0 && searchThreads > 1) {
+    printf("Error: --threads cannot be combined with --games (each game searches on one --workers thread)\n");
     return -1;
   }
-  printf("Socket created successfully\n");
-
-  // Set port and IP the same as server-side
-  server_addr.sin_family = AF_INET;
-  server_addr.sin_port = htons(atoi(argv[2]));
-  server_addr.sin_addr.s_addr = inet_addr(argv[1]);
-
-  // Send connection request to server
-  if ( connect(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0 ) {
-    printf("Unable to connect\n");
+  if (ttMegabytes < 1) ttMegabytes = 1;
+  if (!ttInit(&transTable, ttMegabytes)) {
     return -1;
   }
-  printf("Connected with server successfully\n");
-
-  // Receive the server message
-  memset(server_message, '\0', sizeof(server_message));
-  if ( recv(server_socket, server_message, sizeof(server_message), 0) < 0 ) {
-    printf("Error while receiving server's message\n");
+  if (solveEmpty > 0 && !egInit(&endgameCache, EG_DEFAULT_MB)) {
     return -1;
   }
-  memset(player_message, '\0', sizeof(player_message));
-  snprintf(player_message, sizeof(player_message), "%s %s", argv[3], argv[4]);
-  // Send the message to server
-  if (send(server_socket, player_message, strlen(player_message), 0) < 0) {
-    printf("Unable to send message\n");
+  printf("Transposition table: %d MB\n", ttMegabytes);
+  if (timeLimitMs > 0) {
+    printf("Time limit: %d ms per move (max depth %d)\n", timeLimitMs, searchDepth);
+  }
+  if (searchThreads > 1) {
+    printf("Search threads: %d (Lazy SMP)\n", searchThreads);
+  }
+  if (solveEmpty > 0) {
+    printf("Endgame solver: positions with <= %d empty fields\n", solveEmpty);
+  }
+  tbOpen(&tablebase, tbFile);  // Brak pliku nie jest błędem - gra bez tablicy końcówek
+  if (multiGames > 0) {
+    ponderEnabled = false;  // Pondering tylko w trybie jednej gry
+    if (multiWorkers < 1) {
+      multiWorkers = 1;
+#ifdef _OPENMP
+      multiWorkers = omp_get_max_threads();
+#endif
+    }
+  }
+  if (ponderEnabled) {
+    printf("Pondering: searching opponent replies while waiting\n");
+#ifdef _OPENMP
+    omp_set_max_active_levels(2);  // Wątki Lazy SMP wewnątrz sekcji pondering
+#endif
+  }
+
+  // Wiele gier w jednym procesie: wspólna książka, tablice końcówek i tablica transpozycji
+  if (multiGames > 0) {
+    loadOpeningBook("opening_book_2.txt");
+    int status = playManyGames(argv[1], atoi(argv[2]), argv[3], argv[4]);
+    freeOpeningBook();
+    ttFree(&transTable);
+    egFree(&endgameCache);
+    tbClose(&tablebase);
+    return status;
+  }
+
+  server_socket = connectToServer(argv[1], atoi(argv[2]), argv[3], argv[4], true);
+  if (server_socket < 0) {
     return -1;
   }
 
@@ -186,30 +546,35 @@ int main(int argc, char *argv[]) {
   end_game = false;
   sscanf(argv[3], "%d", &player);
   
+  // Kontekst przeszukiwania na całą grę
+  searchInit(&gameContext, &transTable);
+  gameContext.endgame = (solveEmpty > 0) ? &endgameCache : NULL;
+  gameContext.tablebase = (tablebase.map != NULL) ? &tablebase : NULL;
+
   // Inicjalizacja książki otwarć
-  clearMoveHistory();
   gameMovesCount = 0;
   loadOpeningBook("opening_book_2.txt");  // Załaduj książkę jeśli istnieje
 
+  bool waitingForOpponent = false;  // Wysłaliśmy ruch - przeciwnik myśli
   while (!end_game) {
     memset(server_message, '\0', sizeof(server_message));
-    if (recv(server_socket, server_message, sizeof(server_message), 0) < 0) {
+    if (receiveMessage(server_socket, server_message, sizeof(server_message),
+                       ponderEnabled && waitingForOpponent) < 0) {
       printf("Error while receiving server's message\n");
       return -1;
     }
     sscanf(server_message, "%d", &msg);
     move = msg % 100;
     msg = msg / 100;
+    lastOpponentMove = move;
     if (move != 0) {
       setMove(move, 3 - player);
-      addMoveToHistory(move);  // Dodaj ruch przeciwnika do historii
       gameMovesCount++;
     }
     if ((msg == 0) || (msg == 6)) {
       move = bestMove();
       printf("[SMART BOT] setMove called with move=%d, player=%d (my move)\n", move, player);
       setMove(move, player);
-      addMoveToHistory(move);  // Dodaj swój ruch do historii  
       gameMovesCount++;
       memset(player_message, '\0', sizeof(player_message));
       snprintf(player_message, sizeof(player_message), "%d", move);
@@ -217,6 +582,7 @@ int main(int argc, char *argv[]) {
         printf("Unable to send message\n");
         return -1;
       }
+      waitingForOpponent = true;
     } else {
       end_game = true;
       switch (msg) {
@@ -234,6 +600,9 @@ int main(int argc, char *argv[]) {
   
   // Zwolnij pamięć książki otwarć
   freeOpeningBook();
+  ttFree(&transTable);
+  egFree(&endgameCache);
+  tbClose(&tablebase);
 
   return 0;
 }
\ No newline at end of file
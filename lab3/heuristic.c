@@ -1,100 +1,177 @@
 #include "heuristic.h"
+#include "bitboard.h"
+#include "search.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 // Deklaracje zewnętrzne - zmienne są zdefiniowane w board.h
 extern int board[5][5];
-extern const int win[28][4][2];
-extern const int lose[48][3][2];
 
-// Deklaracje funkcji z board.h
-extern bool winCheck(int who);
-extern bool loseCheck(int who);
-
-// Funkcja oceny planszy dla gracza 'who'
+// Funkcja oceny planszy dla gracza 'who' (wersja na globalnej planszy)
 int evaluateBoard(int who) {
+    BitBoard bb;
+    bbFromBoard(&bb, board);
+    return evaluateBitboard(&bb, who);
+}
+
+// === TABLICE OCENY LINII ===
+
+// Wkład linii zależy tylko od liczby kamieni obu graczy w linii (jej kształtu), więc ocena to
+// suma (liczba linii danego kształtu) * (waga kształtu). Liczniki kształtów są utrzymywane
+// przyrostowo w BitBoard (bbPlace/bbRemove), wagi są liczone raz przy starcie.
+static int winShapeWeight[2][3][BB_WIN_SHAPES];      // [końcówka][gracz][kształt]
+static int loseShapeWeight[3][BB_LOSE_SHAPES];       // [gracz][kształt]
+static bool evaluationInitialized = false;
+
+// Wkład jednej linii 4 w rzędzie przy my_count moich i opp_count cudzych kamieniach
+static int scoreWinLine(int my_count, int opp_count, bool is_endgame) {
     int score = 0;
-    int opponent = 3 - who;
+    int empty_count = 4 - my_count - opp_count;
     
-    // 0. ANALIZA STANU GRY: Policz puste pola (końcówka)
-    int empty_fields = 0;
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (board[i][j] == 0) empty_fields++;
-        }
+    // Sprawdź zagrożenia wygranej (3 moje + 1 puste)
+    if (my_count == 3 && empty_count == 1 && opp_count == 0) {
+        score += 5000;  // Mogę wygrać w następnym ruchu
     }
-    bool is_endgame = (empty_fields <= 8);  // Końcówka gdy ≤8 pustych pól
     
-    // 1. NAJWYŻSZA WAGA: Natychmiastowa wygrana (+10000)
-    if (winCheck(who)) return 10000;
-    if (winCheck(opponent)) return -10000;
-    
-    // 2. NAJWYŻSZA WAGA: Natychmiastowa przegrana (-10000)
-    if (loseCheck(who)) return -10000;
-    if (loseCheck(opponent)) return 10000;
+    // Sprawdź zagrożenia przeciwnika (3 jego + 1 puste)
+    if (opp_count == 3 && empty_count == 1 && my_count == 0) {
+        score -= 3000;  // Muszę blokować
+    }
     
-    // 3. BARDZO WYSOKA WAGA: Sprawdź możliwości wygranej w następnym ruchu
-    int my_win_threats = 0;
-    int opp_win_threats = 0;
-    int my_forced_losses = 0;  // Sytuacje gdzie mogę być zmuszony do 3 w rzędzie
-    int opp_forced_losses = 0; // Sytuacje gdzie przeciwnik może być zmuszony
+    // ANALIZA PRZYMUSU: Sprawdź czy ktoś będzie zmuszony do ruchu
+    if (my_count == 2 && empty_count == 1 && opp_count == 1) {
+        // Mam 2, przeciwnik zablokował 1 pozycję, zostaje mi 1 opcja
+        if (is_endgame) {
+            score -= 400; // W końcówce mogę być zmuszony do złego ruchu (licznik pułapek)
+        } else {
+            score -= 100; // W mid-game mniej groźne
+        }
+    }
     
-    // Sprawdź wszystkie wzorce 4 w rzędzie
-    for (int i = 0; i < 28; i++) {
-        int my_count = 0, opp_count = 0, empty_count = 0;
-        for (int j = 0; j < 4; j++) {
-            int row = win[i][j][0];
-            int col = win[i][j][1];
-            if (board[row][col] == who) my_count++;
-            else if (board[row][col] == opponent) opp_count++;
-            else empty_count++;
+    if (opp_count == 2 && empty_count == 1 && my_count == 1) {
+        // Przeciwnik ma 2, ja zablokowałem 1, zostaje mu 1 opcja
+        if (is_endgame) {
+            score += 300; // Przeciwnik może być zmuszony (licznik pułapek)
+        } else {
+            score += 80;
         }
-        
-        // Sprawdź zagrożenia wygranej (3 moje + 1 puste)
-        if (my_count == 3 && empty_count == 1 && opp_count == 0) {
-            my_win_threats++;
-            score += 5000;  // Mogę wygrać w następnym ruchu
+    }
+    
+    // Sprawdź budowanie pozycji (2 + 2 puste)
+    if (my_count == 2 && empty_count == 2 && opp_count == 0) {
+        if (is_endgame) {
+            score += 150;  // W końcówce mniej agresywnie
+        } else {
+            score += 200;  // W mid-game buduj pozycję
         }
-        
-        // Sprawdź zagrożenia przeciwnika (3 jego + 1 puste)
-        if (opp_count == 3 && empty_count == 1 && my_count == 0) {
-            opp_win_threats++;
-            score -= 3000;  // Muszę blokować
+    }
+    if (opp_count == 2 && empty_count == 2 && my_count == 0) {
+        score -= 100;   // Przeciwnik buduje pozycję
+    }
+    
+    // NISKA WAGA: Analiza wzorców rozwoju (kontrola opcji)
+    if (my_count == 2 && opp_count == 0) {
+        if (empty_count >= 2) {
+            score += 50;  // Bezpieczny wzorzec - mam wybór opcji
+        } else if (empty_count == 1) {
+            score -= 30;  // Niebezpieczny - tylko jedna opcja (ryzyko XXX)
         }
-        
-        // ANALIZA PRZYMUSU: Sprawdź czy ktoś będzie zmuszony do ruchu
-        if (my_count == 2 && empty_count == 1 && opp_count == 1) {
-            // Mam 2, przeciwnik zablokował 1 pozycję, zostaje mi 1 opcja
-            if (is_endgame) {
-                my_forced_losses++; // W końcówce mogę być zmuszony do złego ruchu
-                score -= 400;
-            } else {
-                score -= 100; // W mid-game mniej groźne
-            }
+    }
+    
+    if (my_count == 1 && opp_count == 0 && empty_count == 3) {
+        score += 15;  // Dobry start - dużo opcji rozwoju
+    }
+    
+    // Analiza wzorców przeciwnika (blokowanie jego opcji)
+    if (opp_count == 2 && my_count == 0) {
+        if (empty_count >= 2) {
+            score -= 40;  // Przeciwnik ma bezpieczny wzorzec
+        } else if (empty_count == 1) {
+            score += 20;  // Przeciwnik w pułapce - tylko jedna opcja
         }
-        
-        if (opp_count == 2 && empty_count == 1 && my_count == 1) {
-            // Przeciwnik ma 2, ja zablokowałem 1, zostaje mu 1 opcja
-            if (is_endgame) {
-                opp_forced_losses++; // Przeciwnik może być zmuszony
-                score += 300;
-            } else {
-                score += 80;
+    }
+    
+    if (opp_count == 1 && my_count == 0 && empty_count == 3) {
+        score -= 10;  // Przeciwnik ma dobre opcje rozwoju
+    }
+    
+    // Premiuj dzielenie linii przeciwnika (blokowanie)
+    if (opp_count >= 1 && my_count >= 1) {
+        score += 25;  // Podzieliłem jego linię
+    }
+    return score;
+}
+
+// Wkład jednej linii 3 w rzędzie (ryzyko stworzenia 3 w rzędzie)
+static int scoreLoseLine(int my_count, int opp_count) {
+    int score = 0;
+    if (my_count == 2) score -= 150;    // Ryzyko stworzenia 3 w rzędzie
+    if (opp_count == 2) score += 100;   // Przeciwnik w ryzyku
+    return score;
+}
+
+void initEvaluation(void) {
+    if (evaluationInitialized) return;
+    
+    for (int who = 1; who <= 2; who++) {
+        for (int n1 = 0; n1 <= 4; n1++) {
+            for (int n2 = 0; n1 + n2 <= 4; n2++) {
+                int my_count = (who == 1) ? n1 : n2;
+                int opp_count = (who == 1) ? n2 : n1;
+                winShapeWeight[0][who][bbWinShape(n1, n2)] = scoreWinLine(my_count, opp_count, false);
+                winShapeWeight[1][who][bbWinShape(n1, n2)] = scoreWinLine(my_count, opp_count, true);
             }
         }
-        
-        // Sprawdź budowanie pozycji (2 + 2 puste)
-        if (my_count == 2 && empty_count == 2 && opp_count == 0) {
-            if (is_endgame) {
-                score += 150;  // W końcówce mniej agresywnie
-            } else {
-                score += 200;  // W mid-game buduj pozycję
+        for (int n1 = 0; n1 <= 3; n1++) {
+            for (int n2 = 0; n1 + n2 <= 3; n2++) {
+                int my_count = (who == 1) ? n1 : n2;
+                int opp_count = (who == 1) ? n2 : n1;
+                loseShapeWeight[who][bbLoseShape(n1, n2)] = scoreLoseLine(my_count, opp_count);
             }
         }
-        if (opp_count == 2 && empty_count == 2 && my_count == 0) {
-            score -= 100;   // Przeciwnik buduje pozycję
-        }
     }
+    evaluationInitialized = true;
+}
+
+// Kształt linii z perspektywy gracza 'who' (my_count jego kamieni, opp_count przeciwnika)
+static inline int shapeFor(int who, int my_count, int opp_count) {
+    return (who == 1) ? bbWinShape(my_count, opp_count) : bbWinShape(opp_count, my_count);
+}
+
+// Funkcja oceny pozycji bitboardowej dla gracza 'who' - suma wag kształtów linii
+int evaluateBitboard(const BitBoard* bb, int who) {
+    int score = 0;
+    int opponent = 3 - who;
+    uint32_t mine = bb->stones[who];
+    uint32_t theirs = bb->stones[opponent];
+    
+    // 0. ANALIZA STANU GRY: Policz puste pola (końcówka)
+    int empty_fields = __builtin_popcount(bbEmpty(bb));
+    bool is_endgame = (empty_fields <= 8);  // Końcówka gdy ≤8 pustych pól
     
+    // 1. NAJWYŻSZA WAGA: Natychmiastowa wygrana (+10000)
+    if (bb->winShapes[shapeFor(who, 4, 0)]) return 10000;
+    if (bb->winShapes[shapeFor(who, 0, 4)]) return -10000;
+    
+    // 2. NAJWYŻSZA WAGA: Natychmiastowa przegrana (-10000)
+    int myLose = (who == 1) ? bbLoseShape(3, 0) : bbLoseShape(0, 3);
+    int oppLose = (who == 1) ? bbLoseShape(0, 3) : bbLoseShape(3, 0);
+    if (bb->loseShapes[myLose]) return -10000;
+    if (bb->loseShapes[oppLose]) return 10000;
+    
+    // 3. Wzorce 4 w rzędzie i 3 w rzędzie - liczba linii każdego kształtu razy jego waga
+    const int* winWeight = winShapeWeight[is_endgame][who];
+    for (int shape = 0; shape < BB_WIN_SHAPES; shape++) {
+        score += winWeight[shape] * bb->winShapes[shape];
+    }
+    const int* loseWeight = loseShapeWeight[who];
+    for (int shape = 0; shape < BB_LOSE_SHAPES; shape++) {
+        score += loseWeight[shape] * bb->loseShapes[shape];
+    }
+    int my_win_threats = bb->winShapes[shapeFor(who, 3, 0)];
+    int opp_win_threats = bb->winShapes[shapeFor(who, 0, 3)];
+    int my_forced_losses = is_endgame ? bb->winShapes[shapeFor(who, 2, 1)] : 0;
+    int opp_forced_losses = is_endgame ? bb->winShapes[shapeFor(who, 1, 2)] : 0;
     // 4. BARDZO WYSOKA WAGA: Wykryj widełki (2+ zagrożenia jednocześnie)
     if (my_win_threats >= 2) {
         score += 9999;  // WIDEŁKI! Nie do obrony
@@ -122,151 +199,25 @@ int evaluateBoard(int who) {
         }
     }
     
-    // 5. ŚREDNIA WAGA: Sprawdź niebezpieczne wzorce 3 w rzędzie
-    for (int i = 0; i < 48; i++) {
-        int my_count = 0, opp_count = 0;
-        for (int j = 0; j < 3; j++) {
-            int row = lose[i][j][0];
-            int col = lose[i][j][1];
-            if (board[row][col] == who) my_count++;
-            else if (board[row][col] == opponent) opp_count++;
-        }
-        
-        // Sprawdź ryzyko 3 w rzędzie
-        if (my_count == 2) score -= 150;    // Ryzyko stworzenia 3 w rzędzie
-        if (opp_count == 2) score += 100;   // Przeciwnik w ryzyku
-    }
+    // 6. BARDZO NISKA WAGA: Kontrola centrum planszy
+    const uint32_t center = 1u << 12;
+    if (mine & center) score += 25;
+    if (theirs & center) score -= 20;
     
-    // 6. NISKA WAGA: Analiza wzorców rozwoju (kontrola opcji)
-    for (int i = 0; i < 28; i++) {
-        int my_count = 0, opp_count = 0, empty_count = 0;
-        for (int j = 0; j < 4; j++) {
-            int row = win[i][j][0];
-            int col = win[i][j][1];
-            if (board[row][col] == who) my_count++;
-            else if (board[row][col] == opponent) opp_count++;
-            else empty_count++;
-        }
-        
-        // Analiza moich wzorców rozwoju
-        if (my_count == 2 && opp_count == 0) {
-            if (empty_count >= 2) {
-                score += 50;  // Bezpieczny wzorzec - mam wybór opcji
-            } else if (empty_count == 1) {
-                score -= 30;  // Niebezpieczny - tylko jedna opcja (ryzyko XXX)
-            }
-        }
-        
-        if (my_count == 1 && opp_count == 0 && empty_count == 3) {
-            score += 15;  // Dobry start - dużo opcji rozwoju
-        }
-        
-        // Analiza wzorców przeciwnika (blokowanie jego opcji)
-        if (opp_count == 2 && my_count == 0) {
-            if (empty_count >= 2) {
-                score -= 40;  // Przeciwnik ma bezpieczny wzorzec
-            } else if (empty_count == 1) {
-                score += 20;  // Przeciwnik w pułapce - tylko jedna opcja
-            }
-        }
-        
-        if (opp_count == 1 && my_count == 0 && empty_count == 3) {
-            score -= 10;  // Przeciwnik ma dobre opcje rozwoju
-        }
-        
-        // Premiuj dzielenie linii przeciwnika (blokowanie)
-        if (opp_count >= 1 && my_count >= 1) {
-            score += 25;  // Podzieliłem jego linię
-        }
-    }
-    
-    // 7. BARDZO NISKA WAGA: Kontrola centrum planszy
-    if (board[2][2] == who) score += 25;
-    if (board[2][2] == opponent) score -= 20;
-    
-    // Sprawdź pola obok centrum
-    int center_positions[][2] = {{1,1}, {1,2}, {1,3}, {2,1}, {2,3}, {3,1}, {3,2}, {3,3}};
-    for (int i = 0; i < 8; i++) {
-        int row = center_positions[i][0];
-        int col = center_positions[i][1];
-        if (board[row][col] == who) score += 5;
-        if (board[row][col] == opponent) score -= 3;
-    }
+    // Sprawdź pola obok centrum: (1,1) (1,2) (1,3) (2,1) (2,3) (3,1) (3,2) (3,3)
+    const uint32_t near_center = (7u << 6) | (5u << 11) | (7u << 16);
+    score += 5 * __builtin_popcount(mine & near_center);
+    score -= 3 * __builtin_popcount(theirs & near_center);
     
     return score;
 }
 
-// Algorytm minimax z przycinaniem alfa-beta - POPRAWIONY
+// Algorytm minimax z przycinaniem alfa-beta na globalnej planszy (bez tablicy transpozycji)
 int minimax(int depth, int alpha, int beta, int currentPlayer, bool maximizing, int player) {
-    // Sprawdź stany końcowe przed sprawdzaniem głębokości
-    if (winCheck(player)) return 10000;        // Wygrana gracza
-    if (winCheck(3 - player)) return -10000;   // Wygrana przeciwnika
-    if (loseCheck(player)) return -10000;      // Przegrana gracza (3 w rzędzie)
-    if (loseCheck(3 - player)) return 10000;   // Przegrana przeciwnika (3 w rzędzie)
-    
-    // Sprawdź głębokość
-    if (depth == 0) {
-        return evaluateBoard(player);
-    }
-    
-    int best;
-    if (maximizing) {
-        best = -100000;
-        bool hasLegalMove = false;
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 5; j++) {
-                if (board[i][j] == 0) {
-                    board[i][j] = currentPlayer;
-                    
-                    // Sprawdź czy ruch jest legalny
-                    bool isLegal = !(loseCheck(currentPlayer) && !winCheck(currentPlayer));
-                    
-                    if (isLegal) {
-                        hasLegalMove = true;
-                        int val = minimax(depth - 1, alpha, beta, 3 - currentPlayer, false, player);
-                        board[i][j] = 0;
-                        if (val > best) best = val;
-                        if (best > alpha) alpha = best;
-                        if (beta <= alpha) {
-                            return best; // Przycinanie alfa-beta
-                        }
-                    } else {
-                        board[i][j] = 0; // Cofnij nielegalny ruch
-                    }
-                }
-            }
-        }
-        // Jeśli nie ma legalnych ruchów, to przegrana
-        if (!hasLegalMove) return -10000;
-        return best;
-    } else {
-        best = 100000;
-        bool hasLegalMove = false;
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 5; j++) {
-                if (board[i][j] == 0) {
-                    board[i][j] = currentPlayer;
-                    
-                    // Sprawdź czy ruch jest legalny
-                    bool isLegal = !(loseCheck(currentPlayer) && !winCheck(currentPlayer));
-                    
-                    if (isLegal) {
-                        hasLegalMove = true;
-                        int val = minimax(depth - 1, alpha, beta, 3 - currentPlayer, true, player);
-                        board[i][j] = 0;
-                        if (val < best) best = val;
-                        if (best < beta) beta = best;
-                        if (beta <= alpha) {
-                            return best; // Przycinanie alfa-beta
-                        }
-                    } else {
-                        board[i][j] = 0; // Cofnij nielegalny ruch
-                    }
-                }
-            }
-        }
-        // Jeśli nie ma legalnych ruchów, to przegrana
-        if (!hasLegalMove) return 10000; // Przeciwnik przegrywa = my wygrywamy
-        return best;
-    }
+    SearchContext ctx;
+    BitBoard bb;
+    bbFromBoard(&bb, board);
+    searchInit(&ctx, NULL);
+    searchSetPosition(&ctx, &bb);
+    return searchMinimax(&ctx, depth, alpha, beta, currentPlayer, maximizing, player);
 }
@@ -2,9 +2,15 @@
 #define HEURISTIC_H
 
 #include <stdbool.h>
+#include "bitboard.h"
 
-// Deklaracje funkcji heurystycznych
+// Funkcja oceny - jedna dla gry, uczenia książki i analizy.
+// initEvaluation() buduje tablice wag linii (wywołać raz po initBitboards)
+void initEvaluation(void);
 int evaluateBoard(int who);
+int evaluateBitboard(const BitBoard* bb, int who);
+
+// Minimax na globalnej planszy z board.h (opakowanie searchMinimax z search.h)
 int minimax(int depth, int alpha, int beta, int currentPlayer, bool maximizing, int player);
 
 #endif // HEURISTIC_H
@@ -1,9 +1,15 @@
 #include "opening_book.h"
-#include "heuristic.h"
+#include "search.h"
+#include "bitboard.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -12,204 +18,227 @@
 OpeningEntry* openingBook = NULL;
 int bookSize = 0;
 int bookCapacity = 0;
-int moveHistory[25];
-int historyLength = 0;
 
-// Hash table dla szybkiego wyszukiwania
-HashNode* hashTable[HASH_TABLE_SIZE];
+// Binarna książka zmapowana w pamięci (NULL = brak, używana jest książka tekstowa)
+static void* binaryBookMap = NULL;
+static size_t binaryBookMapSize = 0;
+static const BookEntry* binaryBook = NULL;
+static uint64_t binaryBookCount = 0;
 
-// Zewnętrzne definicje z board.h
-extern const int win[28][4][2];
-extern const int lose[48][3][2];
+// === TABLICA Z ADRESOWANIEM OTWARTYM ===
 
-// === FUNKCJE HASH TABLE ===
-
-// Funkcja hash - djb2 algorithm
-unsigned int hash(const char* str) {
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
-    }
-    return hash % HASH_TABLE_SIZE;
+// Pierwszy slot dla kodu - kod pozycji ma mało zmiennych bitów, więc najpierw mieszanie.
+// Mnożenie starszych 32 bitów przez liczbę slotów zamiast maski: rozmiar nie musi być potęgą 2.
+static inline size_t bookSlot(uint64_t code, int capacity) {
+    code ^= code >> 33;
+    code *= 0xFF51AFD7ED558CCDull;
+    code ^= code >> 33;
+    return (size_t)(((code >> 32) * (uint64_t)capacity) >> 32);
 }
 
-// Inicjalizacja hash table
-void initHashTable(void) {
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        hashTable[i] = NULL;
+// Szuka slotu z kluczem 'key' albo pierwszego wolnego (próbkowanie liniowe)
+static OpeningEntry* probeSlot(OpeningEntry* slots, int capacity, uint64_t key) {
+    for (size_t i = bookSlot(key & ~BOOK_KEY_USED, capacity);; i = (i + 1 == (size_t)capacity) ? 0 : i + 1) {
+        uint64_t current = __atomic_load_n(&slots[i].key, __ATOMIC_ACQUIRE);
+        if (current == key || current == 0) return &slots[i];
     }
 }
 
-// Dodaj wpis do hash table
-void addToHashTable(const char* sequence, int move, int score, int depth) {
-    unsigned int index = hash(sequence);
-    
-    HashNode* newNode = malloc(sizeof(HashNode));
-    if (!newNode) {
-        printf("Error: Cannot allocate memory for hash node!\n");
-        return;
+// Wszystkie sloty w jednym bloku - zwalniane jednym free()
+static void resizeOpeningBook(int capacity) {
+    OpeningEntry* slots = calloc(capacity, sizeof(OpeningEntry));
+    if (!slots) {
+        printf("Error: Cannot allocate memory for opening book!\n");
+        exit(1);
     }
-    
-    strcpy(newNode->sequence, sequence);
-    newNode->best_move = move;
-    newNode->score = score;
-    newNode->depth_analyzed = depth;
-    newNode->next = hashTable[index];  // Dodaj na początku łańcucha
-    hashTable[index] = newNode;
-}
-
-// Znajdź wpis w hash table
-HashNode* findInHashTable(const char* sequence) {
-    unsigned int index = hash(sequence);
-    HashNode* current = hashTable[index];
-    
-    while (current) {
-        if (strcmp(current->sequence, sequence) == 0) {
-            return current;
+    for (int i = 0; i < bookCapacity; i++) {
+        if (openingBook[i].key != 0) {
+            *probeSlot(slots, capacity, openingBook[i].key) = openingBook[i];
         }
-        current = current->next;
     }
-    
-    return NULL;  // Nie znaleziono
+    free(openingBook);
+    openingBook = slots;
+    bookCapacity = capacity;
 }
 
-// Zwolnij pamięć hash table
-void freeHashTable(void) {
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        HashNode* current = hashTable[i];
-        while (current) {
-            HashNode* temp = current;
-            current = current->next;
-            free(temp);
-        }
-        hashTable[i] = NULL;
-    }
+// Liczba slotów dla wypełnienia co najwyżej 3/4 (wielokrotność 64, co najmniej BOOK_INITIAL_CAPACITY)
+static int bookCapacityFor(int entries) {
+    long long capacity = ((long long)entries * 4 + 2) / 3;
+    capacity = (capacity + 63) & ~63ll;
+    return (capacity < BOOK_INITIAL_CAPACITY) ? BOOK_INITIAL_CAPACITY : (int)capacity;
 }
 
-// === ZARZĄDZANIE HISTORIĄ RUCHÓW ===
-
-void clearMoveHistory(void) {
-    historyLength = 0;
-    memset(moveHistory, 0, sizeof(moveHistory));
+OpeningEntry* findOpeningEntry(uint64_t code) {
+    if (openingBook == NULL) return NULL;
+    OpeningEntry* entry = probeSlot(openingBook, bookCapacity, code | BOOK_KEY_USED);
+    return (entry->key != 0) ? entry : NULL;
 }
 
-void addMoveToHistory(int move) {
-    if (historyLength < 25) {
-        moveHistory[historyLength++] = move;
+// === POZYCJE ===
+
+// Odtwarza pozycję po sekwencji ruchów ("33,22,43"); false = ruch spoza planszy lub na zajęte pole
+bool sequenceToBoard(const char* sequence, BitBoard* bb, int* toMove) {
+    bbClear(bb);
+    *toMove = 1;
+    const char* p = sequence;
+    while (*p) {
+        char* end;
+        long move = strtol(p, &end, 10);
+        if (end == p) return false;
+        int row = (int)(move / 10), col = (int)(move % 10);
+        if (row < 1 || row > 5 || col < 1 || col > 5) return false;
+        int cell = bbMoveToCell((int)move);
+        if (bbCellOwner(bb, cell) != 0) return false;
+        bbPlace(bb, cell, *toMove);
+        *toMove = 3 - *toMove;
+        p = (*end == ',') ? end + 1 : end;
     }
+    return true;
 }
 
-char* buildMoveSequence(void) {
-    static char sequence[MAX_SEQUENCE_LENGTH];
-    sequence[0] = '\0';
-    
-    for (int i = 0; i < historyLength; i++) {
-        if (i > 0) strcat(sequence, ",");
-        char moveStr[10];
-        sprintf(moveStr, "%d", moveHistory[i]);
-        strcat(sequence, moveStr);
-    }
-    return sequence;
+static bool isBoardMove(int move) {
+    int row = move / 10, col = move % 10;
+    return row >= 1 && row <= 5 && col >= 1 && col <= 5;
 }
 
-int getMoveCount(void) {
-    return historyLength;
+// === ZARZĄDZANIE KSIĄŻKĄ ===
+
+void initOpeningBook(void) {
+    reserveOpeningBook(0);
 }
 
-// === THREAD-SAFE FUNCTIONS ===
+void reserveOpeningBook(int entries) {
+    int capacity = bookCapacityFor(entries > bookSize ? entries : bookSize);
+    if (openingBook == NULL || capacity > bookCapacity) {
+        resizeOpeningBook(capacity);
+    }
+}
 
-// Mutex do synchronizacji dostępu do książki otwarć
-#ifdef _OPENMP
-static omp_lock_t book_lock;
-static bool lock_initialized = false;
+// Reguła "głębsza analiza wygrywa" jako pętla CAS - przy równej głębokości zostaje stary wpis.
+// data == 0 oznacza slot zajęty, ale jeszcze niewypełniony (ruch nigdy nie jest 0).
+static void keepDeeper(OpeningEntry* entry, uint64_t data) {
+    uint64_t current = __atomic_load_n(&entry->data, __ATOMIC_ACQUIRE);
+    while (current == 0 || bookEntryDepth(current) < bookEntryDepth(data)) {
+        if (__atomic_compare_exchange_n(&entry->data, &current, data, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
+}
 
-void init_book_lock() {
-    if (!lock_initialized) {
-        omp_init_lock(&book_lock);
-        lock_initialized = true;
+// Wstawienie bez blokad: slot jest zajmowany przez CAS na kluczu, a gdy inny wątek zajął go
+// w międzyczasie dla innej pozycji, próbkowanie idzie dalej. Tablica nie może być w tym czasie
+// powiększana - wątki uczenia piszą do własnych buforów, a scalanie najpierw rezerwuje miejsce.
+static void insertEntry(uint64_t key, uint64_t data) {
+    size_t capacity = (size_t)bookCapacity;
+    for (size_t i = bookSlot(key & ~BOOK_KEY_USED, bookCapacity);; i = (i + 1 == capacity) ? 0 : i + 1) {
+        OpeningEntry* entry = &openingBook[i];
+        uint64_t current = __atomic_load_n(&entry->key, __ATOMIC_ACQUIRE);
+        if (current == 0 &&
+            __atomic_compare_exchange_n(&entry->key, &current, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_fetch_add(&bookSize, 1, __ATOMIC_RELAXED);
+            keepDeeper(entry, data);
+            return;
+        }
+        if (current == key) {
+            keepDeeper(entry, data);
+            return;
+        }
     }
 }
 
-void cleanup_book_lock() {
-    if (lock_initialized) {
-        omp_destroy_lock(&book_lock);
-        lock_initialized = false;
+// Dodaje wpis już w formie kanonicznej (kod pozycji, ruch w orientacji kanonicznej).
+// Istniejący wpis jest nadpisywany tylko wynikiem głębszej analizy.
+void addCanonicalEntry(uint64_t code, int canonicalMove, int score, int depth) {
+    if (openingBook == NULL || (bookSize + 1) * 4 > bookCapacity * 3) {
+        reserveOpeningBook(bookSize * 2 + 1);  // Podwojenie przy wypełnieniu powyżej 3/4
     }
+    insertEntry(code | BOOK_KEY_USED, bookPackData(canonicalMove, score, depth));
 }
-#endif
 
-// Thread-safe dodawanie wpisu do książki
-void addOpeningEntryThreadSafe(const char* sequence, int move, int score, int depth) {
-#ifdef _OPENMP
-    omp_set_lock(&book_lock);
-#endif
-    addOpeningEntry(sequence, move, score, depth);
-#ifdef _OPENMP
-    omp_unset_lock(&book_lock);
-#endif
+// Ruch 'move' gracza 'toMove' w pozycji 'bb' - jeden wpis dla wszystkich symetrii i kolejności ruchów
+void addOpeningEntry(const BitBoard* bb, int toMove, int move, int score, int depth) {
+    int orientation;
+    uint64_t code = bbCanonicalCodeOriented(bb, toMove, &orientation);
+    int canonicalMove = bbCellToMove(bbSymCell[orientation][bbMoveToCell(move)]);
+    addCanonicalEntry(code, canonicalMove, score, depth);
 }
 
-// === ZARZĄDZANIE KSIĄŻKĄ ===
+// === BUFORY WĄTKÓW UCZENIA ===
 
-void initOpeningBook(void) {
-    if (openingBook == NULL) {
-        bookCapacity = 1000;
-        openingBook = malloc(bookCapacity * sizeof(OpeningEntry));
-        bookSize = 0;
-    }
-    initHashTable();  // Inicjalizuj hash table
+// Wpisy jednego wątku - dopisywane bez synchronizacji, scalane z książką na końcu uczenia.
+// Wyrównanie do linii cache, żeby liczniki sąsiednich wątków nie dzieliły linii.
+// Punkt kontrolny czyta bufory w trakcie pracy: wskaźnik i licznik są publikowane atomowo
+// (licznik po zapisaniu wpisu), a poprzednie tablice żyją do scalenia.
+typedef struct {
+    _Alignas(64) OpeningEntry* entries;
+    int count;
+    int capacity;
+    OpeningEntry* retired[32];
+    int retiredCount;
+} BookBuffer;
+
+static BookBuffer* bookBuffers = NULL;
+static int bookBufferCount = 0;
+
+static void initBookBuffers(int threads) {
+    bookBuffers = calloc(threads, sizeof(BookBuffer));
+    bookBufferCount = bookBuffers ? threads : 0;
 }
 
-void addOpeningEntry(const char* sequence, int move, int score, int depth) {
-    initOpeningBook();
-    
-    // Konwertuj do kanonicznej formy (uwzględniając symetrie)
-    char canonicalSeq[MAX_SEQUENCE_LENGTH];
-    int transform;
-    getCanonicalSequence(sequence, canonicalSeq, &transform);
-    
-    // Transformuj też ruch do odpowiedniej formy kanonicznej
-    int canonicalMove = transformMove(move, transform);
-    
-    // Sprawdź czy wpis już istnieje w formie kanonicznej
-    for (int i = 0; i < bookSize; i++) {
-        if (strcmp(openingBook[i].sequence, canonicalSeq) == 0) {
-            if (depth > openingBook[i].depth_analyzed) {
-                openingBook[i].best_move = canonicalMove;
-                openingBook[i].score = score;
-                openingBook[i].depth_analyzed = depth;
-                
-                // Aktualizuj też hash table
-                HashNode* node = findInHashTable(canonicalSeq);
-                if (node) {
-                    node->best_move = canonicalMove;
-                    node->score = score;
-                    node->depth_analyzed = depth;
-                }
-            }
-            return;
-        }
+// Wpis z wątku uczenia: trafia do bufora wątku (bez blokad i bez dostępu do wspólnej tablicy)
+static void bufferOpeningEntry(const BitBoard* bb, int toMove, int move, int score, int depth) {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    if (thread >= bookBufferCount) {
+        addOpeningEntry(bb, toMove, move, score, depth);  // Bez buforów - tylko jeden wątek
+        return;
     }
-    
-    // Dodaj nowy wpis w formie kanonicznej
-    if (bookSize >= bookCapacity) {
-        bookCapacity *= 2;
-        openingBook = realloc(openingBook, bookCapacity * sizeof(OpeningEntry));
-        if (!openingBook) {
-            printf("Error: Cannot allocate memory for opening book!\n");
+    BookBuffer* buffer = &bookBuffers[thread];
+    if (buffer->count == buffer->capacity) {
+        int capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        OpeningEntry* grown = malloc(capacity * sizeof(OpeningEntry));
+        if (!grown) {
+            printf("Error: Cannot allocate memory for book buffer!\n");
             exit(1);
         }
+        if (buffer->entries) {
+            memcpy(grown, buffer->entries, buffer->count * sizeof(OpeningEntry));
+            buffer->retired[buffer->retiredCount++] = buffer->entries;
+        }
+        __atomic_store_n(&buffer->entries, grown, __ATOMIC_RELEASE);
+        buffer->capacity = capacity;
     }
-    
-    strcpy(openingBook[bookSize].sequence, canonicalSeq);
-    openingBook[bookSize].best_move = canonicalMove;
-    openingBook[bookSize].score = score;
-    openingBook[bookSize].depth_analyzed = depth;
-    bookSize++;
-    
-    // Dodaj też do hash table dla szybkiego wyszukiwania
-    addToHashTable(canonicalSeq, canonicalMove, score, depth);
+    int orientation;
+    uint64_t code = bbCanonicalCodeOriented(bb, toMove, &orientation);
+    int canonicalMove = bbCellToMove(bbSymCell[orientation][bbMoveToCell(move)]);
+    buffer->entries[buffer->count].key = code | BOOK_KEY_USED;
+    buffer->entries[buffer->count].data = bookPackData(canonicalMove, score, depth);
+    __atomic_store_n(&buffer->count, buffer->count + 1, __ATOMIC_RELEASE);
+}
+
+// Scalanie buforów: jedna rezerwacja na wszystkie wpisy, potem równoległe wstawianie CAS
+static void mergeBookBuffers(void) {
+    int total = 0;
+    for (int t = 0; t < bookBufferCount; t++) total += bookBuffers[t].count;
+    reserveOpeningBook(bookSize + total);
+    for (int t = 0; t < bookBufferCount; t++) {
+        BookBuffer* buffer = &bookBuffers[t];
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < buffer->count; i++) {
+            insertEntry(buffer->entries[i].key, buffer->entries[i].data);
+        }
+        free(buffer->entries);
+        for (int r = 0; r < buffer->retiredCount; r++) free(buffer->retired[r]);
+    }
+    printf("[LEARN] Merged %d buffered entries from %d threads, book has %d positions\n",
+           total, bookBufferCount, bookSize);
+    free(bookBuffers);
+    bookBuffers = NULL;
+    bookBufferCount = 0;
 }
 
 void freeOpeningBook(void) {
@@ -219,7 +248,13 @@ void freeOpeningBook(void) {
         bookSize = 0;
         bookCapacity = 0;
     }
-    freeHashTable();  // Zwolnij hash table
+    if (binaryBookMap) {
+        munmap(binaryBookMap, binaryBookMapSize);
+        binaryBookMap = NULL;
+        binaryBookMapSize = 0;
+        binaryBook = NULL;
+        binaryBookCount = 0;
+    }
 }
 
 // === UŻYCIE KSIĄŻKI W GRZE ===
@@ -228,79 +263,57 @@ bool isInOpeningPhase(int moveCount) {
     return moveCount <= MAX_OPENING_MOVES;
 }
 
-int getOpeningMove(const char* moveSequence, int moveCount) {
-    printf("[DEBUG GET] Called with sequence='%s', moveCount=%d\n", moveSequence, moveCount);
-    
+// Ruch w orientacji kanonicznej dla kodu pozycji (0 = brak wpisu)
+static int findCanonicalMove(uint64_t code) {
+    if (binaryBook) {
+        uint64_t lo = 0, hi = binaryBookCount;
+        while (lo < hi) {
+            uint64_t mid = (lo + hi) / 2;
+            if (binaryBook[mid].code == code) return bbCellToMove(binaryBook[mid].cell);
+            if (binaryBook[mid].code < code) lo = mid + 1;
+            else hi = mid;
+        }
+        return 0;
+    }
+    OpeningEntry* entry = findOpeningEntry(code);
+    return entry ? bookEntryMove(entry->data) : 0;
+}
+
+int getOpeningMove(const BitBoard* bb, int toMove) {
     // Sprawdź czy jesteśmy w fazie otwarcia
+    int moveCount = __builtin_popcount(bb->stones[1] | bb->stones[2]);
     if (!isInOpeningPhase(moveCount)) {
-        printf("[DEBUG GET] Not in opening phase\n");
         return 0; // Poza fazą otwarcia
     }
-    
-    if (openingBook == NULL || bookSize == 0) {
-        printf("[DEBUG GET] No opening book loaded\n");
+    if (binaryBook == NULL && (openingBook == NULL || bookSize == 0)) {
         return 0; // Brak książki
     }
     
-    printf("[DEBUG GET] Opening book has %d entries\n", bookSize);
-    
-    // Konwertuj sekwencję do formy kanonicznej
-    char canonicalSeq[MAX_SEQUENCE_LENGTH];
-    int transform;
-    getCanonicalSequence(moveSequence, canonicalSeq, &transform);
-    
-    printf("[DEBUG GET] Canonical sequence: '%s', transform: %d\n", canonicalSeq, transform);
-    
-    // Szybkie wyszukiwanie w hash table - O(1) zamiast O(n)
-    HashNode* node = findInHashTable(canonicalSeq);
-    if (node) {
-        printf("[DEBUG GET] Found in hash table: move=%d\n", node->best_move);
-        // Ruch jest w formie kanonicznej - musimy go odwrócić do oryginalnej orientacji
-        int canonicalMove = node->best_move;
-        int originalMove = canonicalMove;
-        
-        // Znajdź odwrotną transformację
-        if (transform != 0) {
-            // Testuj wszystkie transformacje, żeby znaleźć tę która odwraca kanoniczną
-            for (int t = 0; t < 8; t++) {
-                int testMove = transformMove(canonicalMove, t);
-                char testSeq[MAX_SEQUENCE_LENGTH];
-                sprintf(testSeq, "%s,%d", moveSequence, testMove);
-                
-                char testCanonical[MAX_SEQUENCE_LENGTH];
-                int testTransform;
-                getCanonicalSequence(testSeq, testCanonical, &testTransform);
-                
-                // Jeśli po dodaniu ruchu i transformacji dostajemy spójną kanoniczną formę
-                if (testTransform == transform) {
-                    originalMove = testMove;
-                    break;
-                }
-            }
-        }
-        
-        printf("[OPENING] Using book move %d for sequence: %s (canonical: %s, move: %d)\n", 
-               originalMove, moveSequence, canonicalSeq, canonicalMove);
-        return originalMove;
-    } else {
-        printf("[DEBUG GET] Not found in hash table for '%s'\n", canonicalSeq);
-        
-        // Fallback - szukaj w tablicy liniowo
-        for (int i = 0; i < bookSize; i++) {
-            if (strcmp(openingBook[i].sequence, canonicalSeq) == 0) {
-                printf("[DEBUG GET] Found in linear search: move=%d\n", openingBook[i].best_move);
-                return openingBook[i].best_move;
-            }
-        }
-        printf("[DEBUG GET] Not found anywhere\n");
-    }
-    
-    return 0; // Nie znaleziono w książce
+    // Jedno wyszukiwanie po kodzie kanonicznym; orientacja z kanonizacji odwraca ruch
+    int orientation;
+    uint64_t code = bbCanonicalCodeOriented(bb, toMove, &orientation);
+    int canonicalMove = findCanonicalMove(code);
+    if (canonicalMove == 0) return 0; // Nie znaleziono w książce
+    
+    int cell = bbSymInverse[orientation][bbMoveToCell(canonicalMove)];
+    if (bbCellOwner(bb, cell) != 0) return 0;  // Uszkodzony wpis
+    printf("[OPENING] Using book move %d (canonical position 0x%013llx, move %d)\n",
+           bbCellToMove(cell), (unsigned long long)code, canonicalMove);
+    return bbCellToMove(cell);
 }
 
 // === ŁADOWANIE/ZAPISYWANIE ===
 
-bool loadOpeningBook(const char* filename) {
+// Nazwa binarnej wersji książki: "opening_book_2.txt" -> "opening_book_2.bin"
+static void binaryBookName(const char* textFile, char* out, size_t size) {
+    size_t length = strlen(textFile);
+    if (length >= 4 && strcmp(textFile + length - 4, ".txt") == 0) length -= 4;
+    snprintf(out, size, "%.*s.bin", (int)length, textFile);
+}
+
+// Format wiersza: "0x<kod pozycji> -> ruch (ocena) [głębokość]" (ruch w orientacji kanonicznej).
+// Starsze wiersze "sekwencja -> ruch (ocena) [głębokość]" są zamieniane na pozycje przy wczytaniu.
+static bool loadTextBook(const char* filename) {
     FILE* file = fopen(filename, "r");
     if (!file) {
         printf("[OPENING] Book file %s not found. Starting with empty book.\n", filename);
@@ -308,177 +321,486 @@ bool loadOpeningBook(const char* filename) {
     }
     
     initOpeningBook();
-    bookSize = 0;
     
     char line[200];
-    int loaded = 0;
+    int loaded = 0, skipped = 0;
     
     while (fgets(line, sizeof(line), file)) {
+        // Liczba wpisów z nagłówka - tablica od razu w docelowym rozmiarze
+        int expected;
+        if (sscanf(line, "# Generated entries: %d", &expected) == 1) {
+            reserveOpeningBook(expected);
+            continue;
+        }
         // Pomiń komentarze i puste linie
         if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
         
-        printf("[DEBUG LOAD] Processing line: '%s'\n", line);
-        
         char sequence[MAX_SEQUENCE_LENGTH];
+        unsigned long long code;
         int move, score, depth;
+        BitBoard bb;
+        int toMove;
         
-        // Specjalne parsowanie dla pustej sekwencji
-        if (sscanf(line, " -> %d (%d) [%d]", &move, &score, &depth) == 3) {
-            // Pusta sekwencja
-            addOpeningEntry("", move, score, depth);
+        if (sscanf(line, "0x%llx -> %d (%d) [%d]", &code, &move, &score, &depth) == 4 && isBoardMove(move)) {
+            addCanonicalEntry(code, move, score, depth);
             loaded++;
-            printf("[DEBUG LOAD] Empty sequence -> %d (score=%d, depth=%d)\n", move, score, depth);
         }
-        // Format: "sequence -> move (score) [depth]"
-        else if (sscanf(line, "%s -> %d (%d) [%d]", sequence, &move, &score, &depth) == 4) {
-            addOpeningEntry(sequence, move, score, depth);
+        // Pusta sekwencja (pozycja startowa)
+        else if (sscanf(line, " -> %d (%d) [%d]", &move, &score, &depth) == 3 && isBoardMove(move)) {
+            bbClear(&bb);
+            addOpeningEntry(&bb, 1, move, score, depth);
+            loaded++;
+        }
+        else if (sscanf(line, "%99s -> %d (%d) [%d]", sequence, &move, &score, &depth) == 4 &&
+                 isBoardMove(move) && sequenceToBoard(sequence, &bb, &toMove) &&
+                 bbCellOwner(&bb, bbMoveToCell(move)) == 0) {
+            addOpeningEntry(&bb, toMove, move, score, depth);
             loaded++;
-            printf("[DEBUG LOAD] %s -> %d (score=%d, depth=%d)\n", sequence, move, score, depth);
         } else {
-            printf("[DEBUG LOAD] Failed to parse line: '%s'\n", line);
+            skipped++;  // Niepoprawny wiersz lub ruch spoza planszy
         }
     }
     
     fclose(file);
-    printf("[OPENING] Loaded %d entries from %s\n", loaded, filename);
+    printf("[OPENING] Loaded %d entries (%d positions) from %s", loaded, bookSize, filename);
+    if (skipped > 0) printf(", skipped %d invalid lines", skipped);
+    printf("\n");
     return true;
 }
 
+// Zapis atomowy: plik tymczasowy obok docelowego, fsync i rename. Przerwany zapis zostawia
+// poprzednią wersję, a książka zmapowana przez działającego bota zostaje ważna.
+static FILE* beginAtomicWrite(const char* filename, const char* mode, char* tempName, size_t size) {
+    snprintf(tempName, size, "%s.tmp", filename);
+    return fopen(tempName, mode);
+}
+
+static bool finishAtomicWrite(FILE* file, const char* tempName, const char* filename, bool ok) {
+    if (fflush(file) != 0 || fsync(fileno(file)) != 0) ok = false;
+    if (fclose(file) != 0) ok = false;
+    if (ok && rename(tempName, filename) != 0) ok = false;
+    if (!ok) remove(tempName);
+    return ok;
+}
+
+static void writeBookHeader(FILE* file, int entries) {
+    fprintf(file, "# Auto-generated Opening Book\n");
+    fprintf(file, "# Max opening moves: %d\n", MAX_OPENING_MOVES);
+    fprintf(file, "# Format: 0x<canonical position> -> move (score) [depth]\n");
+    fprintf(file, "# Position: mover stones | opponent stones << 25, move in canonical orientation\n");
+    fprintf(file, "# Generated entries: %d\n", entries);
+}
+
+static void writeBookLine(FILE* file, uint64_t key, uint64_t data) {
+    fprintf(file, "0x%013llx -> %d (%d) [%d]\n", (unsigned long long)(key & ~BOOK_KEY_USED),
+            bookEntryMove(data), bookEntryScore(data), bookEntryDepth(data));
+}
+
+bool loadOpeningBook(const char* filename) {
+    char binaryFile[256];
+    binaryBookName(filename, binaryFile, sizeof(binaryFile));
+    if (access(binaryFile, R_OK) == 0 && loadBinaryBook(binaryFile)) {
+        return true;
+    }
+    return loadTextBook(filename);
+}
+
 void saveOpeningBook(const char* filename) {
-    FILE* file = fopen(filename, "w");
+    char tempName[256];
+    FILE* file = beginAtomicWrite(filename, "w", tempName, sizeof(tempName));
     if (!file) {
         printf("[OPENING] Error: Cannot save book to %s\n", filename);
         return;
     }
     
-    fprintf(file, "# Auto-generated Opening Book\n");
-    fprintf(file, "# Max opening moves: %d\n", MAX_OPENING_MOVES);
-    fprintf(file, "# Format: sequence -> move (score) [depth]\n");
-    fprintf(file, "# Generated entries: %d\n\n", bookSize);
+    writeBookHeader(file, bookSize);
+    fprintf(file, "\n");
     
-    for (int i = 0; i < bookSize; i++) {
-        fprintf(file, "%s -> %d (%d) [%d]\n", 
-                openingBook[i].sequence,
-                openingBook[i].best_move,
-                openingBook[i].score,
-                openingBook[i].depth_analyzed);
+    for (int i = 0; i < bookCapacity; i++) {
+        if (openingBook[i].key == 0) continue;
+        writeBookLine(file, openingBook[i].key, openingBook[i].data);
     }
     
-    fclose(file);
+    if (!finishAtomicWrite(file, tempName, filename, !ferror(file))) {
+        printf("[OPENING] Error: Cannot write book %s\n", filename);
+        return;
+    }
     printf("[OPENING] Saved %d entries to %s\n", bookSize, filename);
 }
 
+// === BINARNA KSIĄŻKA ===
+
+static int compareBookEntries(const void* a, const void* b) {
+    const BookEntry* x = a;
+    const BookEntry* y = b;
+    return (x->code > y->code) - (x->code < y->code);
+}
+
+// Zapisuje bieżącą książkę w formacie binarnym (wpisy już są kanoniczne i unikalne)
+bool saveBinaryBook(const char* filename) {
+    // Liczba zapisanych wpisów to liczba zajętych slotów (nie bookSize), więc bufor ma rozmiar tablicy
+    BookEntry* entries = malloc((bookCapacity > 0 ? bookCapacity : 1) * sizeof(BookEntry));
+    if (!entries) {
+        printf("[OPENING] Error: Cannot allocate memory for binary book!\n");
+        return false;
+    }
+    int count = 0;
+    for (int i = 0; i < bookCapacity; i++) {
+        if (openingBook[i].key == 0) continue;
+        entries[count].code = openingBook[i].key & ~BOOK_KEY_USED;
+        entries[count].score = bookEntryScore(openingBook[i].data);
+        entries[count].cell = (uint8_t)bbMoveToCell(bookEntryMove(openingBook[i].data));
+        entries[count].depth = (uint8_t)bookEntryDepth(openingBook[i].data);
+        entries[count].reserved = 0;
+        count++;
+    }
+    qsort(entries, count, sizeof(BookEntry), compareBookEntries);
+
+    char tempName[256];
+    FILE* file = beginAtomicWrite(filename, "wb", tempName, sizeof(tempName));
+    if (!file) {
+        printf("[OPENING] Error: Cannot save binary book to %s\n", filename);
+        free(entries);
+        return false;
+    }
+    BookHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.count = count;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(entries, sizeof(BookEntry), count, file) == (size_t)count;
+    ok = finishAtomicWrite(file, tempName, filename, ok);
+    free(entries);
+    if (!ok) {
+        printf("[OPENING] Error: Cannot write binary book %s\n", filename);
+        return false;
+    }
+    printf("[OPENING] Saved %d positions to %s\n", count, filename);
+    return true;
+}
+
+bool loadBinaryBook(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BookHeader)) {
+        printf("[OPENING] Error: Invalid binary book %s\n", filename);
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("[OPENING] Error: Cannot mmap binary book %s\n", filename);
+        return false;
+    }
+    const BookHeader* header = map;
+    if (memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        sizeof(BookHeader) + header->count * sizeof(BookEntry) != (size_t)st.st_size) {
+        printf("[OPENING] Error: Invalid binary book %s\n", filename);
+        munmap(map, st.st_size);
+        return false;
+    }
+    binaryBookMap = map;
+    binaryBookMapSize = st.st_size;
+    binaryBook = (const BookEntry*)(header + 1);
+    binaryBookCount = header->count;
+    printf("[OPENING] Mapped %llu positions from %s\n", (unsigned long long)binaryBookCount, filename);
+    return true;
+}
+
+bool convertOpeningBook(const char* textFile) {
+    char binaryFile[256];
+    binaryBookName(textFile, binaryFile, sizeof(binaryFile));
+    if (!loadTextBook(textFile)) return false;
+    return saveBinaryBook(binaryFile);
+}
+
+// === POMIAR WYDAJNOŚCI ===
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Losowa pozycja otwarcia (1-10 kamieni) i losowy ruch na wolne pole
+static void randomBookPosition(uint64_t* seed, BitBoard* bb, int* toMove, int* move) {
+    bbClear(bb);
+    int stones = 1 + (int)(bbRandom64(seed) % MAX_OPENING_MOVES);
+    *toMove = 1;
+    *move = 0;
+    for (int i = 0; i <= stones; i++) {
+        int cell;
+        do {
+            cell = (int)(bbRandom64(seed) % BB_CELLS);
+        } while (bbCellOwner(bb, cell) != 0);
+        if (i == stones) {
+            *move = bbCellToMove(cell);
+            break;
+        }
+        bbPlace(bb, cell, *toMove);
+        *toMove = 3 - *toMove;
+    }
+}
+
+void benchmarkOpeningBook(int maxEntries) {
+    const char* textFile = "bench_book.txt";
+    const char* binaryFile = "bench_book.bin";
+    printf("=== OPENING BOOK BENCHMARK (up to %d positions) ===\n", maxEntries);
+    uint64_t* codes = malloc((maxEntries > 0 ? maxEntries : 1) * sizeof(uint64_t));
+    if (!codes) {
+        printf("Error: Cannot allocate memory for benchmark!\n");
+        return;
+    }
+
+    for (int size = 1000; size <= maxEntries; size *= 10) {
+        freeOpeningBook();
+        reserveOpeningBook(size);
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        long long inserts = 0;
+        double start = nowSeconds();
+        while (bookSize < size) {
+            BitBoard bb;
+            int toMove, move;
+            randomBookPosition(&seed, &bb, &toMove, &move);
+            addOpeningEntry(&bb, toMove, move, (int)(bbRandom64(&seed) % 2001) - 1000,
+                            1 + (int)(bbRandom64(&seed) % 10));
+            inserts++;
+        }
+        double insertTime = nowSeconds() - start;
+        double bytesPerPosition = (double)bookCapacity * sizeof(OpeningEntry) / bookSize;
+        int count = 0;
+        for (int i = 0; i < bookCapacity; i++) {
+            if (openingBook[i].key != 0) codes[count++] = openingBook[i].key & ~BOOK_KEY_USED;
+        }
+        // Zapytania w losowej kolejności, a nie w kolejności slotów
+        for (int i = count - 1; i > 0; i--) {
+            int j = (int)(bbRandom64(&seed) % (uint64_t)(i + 1));
+            uint64_t code = codes[i];
+            codes[i] = codes[j];
+            codes[j] = code;
+        }
+
+        start = nowSeconds();
+        saveOpeningBook(textFile);
+        saveBinaryBook(binaryFile);
+        double saveTime = nowSeconds() - start;
+
+        freeOpeningBook();
+        start = nowSeconds();
+        loadTextBook(textFile);
+        double textLoadTime = nowSeconds() - start;
+        start = nowSeconds();
+        int found = 0;
+        for (int i = 0; i < count; i++) found += findCanonicalMove(codes[i]) != 0;
+        double textLookupTime = nowSeconds() - start;
+
+        freeOpeningBook();
+        start = nowSeconds();
+        loadBinaryBook(binaryFile);
+        double binaryLoadTime = nowSeconds() - start;
+        start = nowSeconds();
+        for (int i = 0; i < count; i++) found += findCanonicalMove(codes[i]) != 0;
+        double binaryLookupTime = nowSeconds() - start;
+
+        printf("[BENCH] positions=%d inserts=%lld insert=%.3f s save=%.3f s memory=%.1f B/position\n", count,
+               inserts, insertTime, saveTime, bytesPerPosition);
+        printf("[BENCH]   text:   load=%.3f s lookup=%.0f ns\n", textLoadTime, textLookupTime * 1e9 / count);
+        printf("[BENCH]   binary: load=%.6f s lookup=%.0f ns (found %d/%d)\n",
+               binaryLoadTime, binaryLookupTime * 1e9 / count, found, 2 * count);
+    }
+    freeOpeningBook();
+    free(codes);
+    remove(textFile);
+    remove(binaryFile);
+}
+
 // === AUTO-UCZENIE KSIĄŻKI ===
 
-// Deklaracja zewnętrznych funkcji z innych plików
-extern int minimax(int depth, int alpha, int beta, int maximizingPlayer, bool isRoot, int originalPlayer);
-extern bool winCheck(int who);
-extern bool loseCheck(int who);
 extern int board[5][5];
 
-// Funkcja rekurencyjna eksploracji pozycji
-void explorePosition(const char* currentSequence, int currentPlayer, int depth, int maxDepth, int searchDepth) {
-    if (depth > maxDepth) return;
-    
-    // Sprawdź czy pozycja już jest w książce
-    for (int i = 0; i < bookSize; i++) {
-        if (strcmp(openingBook[i].sequence, currentSequence) == 0) {
-            return; // Już mamy tę pozycję
+// Tablica transpozycji uczenia - wspólna dla wszystkich wątków eksploracji
+#define LEARN_TT_MB 64
+static TranspositionTable learnTable;
+static bool learnTableReady = false;
+
+// Poddrzewa do tej głębokości są osobnymi zadaniami OpenMP (głębiej - zwykła rekurencja)
+#define LEARN_SPAWN_DEPTH 4
+
+// Wykorzystanie wątku: zadania, czas w przeszukiwaniu i węzły. Wyrównanie do linii cache,
+// żeby liczniki sąsiednich wątków nie dzieliły linii.
+typedef struct {
+    _Alignas(64) long long tasks;
+    long long nodes;
+    double searchSeconds;
+} LearnThreadStats;
+
+static LearnThreadStats* learnStats = NULL;
+static int learnStatsCount = 0;
+
+static LearnThreadStats* learnThreadStats(void) {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    return (thread < learnStatsCount) ? &learnStats[thread] : NULL;
+}
+
+// searchMinimax z pomiarem czasu i węzłów dla raportu wykorzystania wątków
+static int learnSearch(SearchContext* ctx, int depth, int currentPlayer, int player) {
+    long long nodes = ctx->stats.nodes;
+    double start = nowSeconds();
+    int score = searchMinimax(ctx, depth, -100000, 100000, currentPlayer, false, player);
+    LearnThreadStats* stats = learnThreadStats();
+    if (stats) {
+        stats->searchSeconds += nowSeconds() - start;
+        stats->nodes += ctx->stats.nodes - nodes;
+    }
+    return score;
+}
+
+static void printLearnUtilization(double wallSeconds) {
+    printf("\n[LEARN] Thread utilization (wall %.1f s):\n", wallSeconds);
+    long long totalTasks = 0, totalNodes = 0;
+    double totalSearch = 0.0;
+    for (int t = 0; t < learnStatsCount; t++) {
+        const LearnThreadStats* stats = &learnStats[t];
+        printf("[LEARN]   thread %2d: tasks=%lld search=%.1f s (%.1f%%) nodes=%lld\n", t, stats->tasks,
+               stats->searchSeconds, wallSeconds > 0 ? stats->searchSeconds * 100.0 / wallSeconds : 0.0,
+               stats->nodes);
+        totalTasks += stats->tasks;
+        totalNodes += stats->nodes;
+        totalSearch += stats->searchSeconds;
+    }
+    double capacity = wallSeconds * learnStatsCount;
+    printf("[LEARN]   total: tasks=%lld nodes=%lld utilization=%.1f%%\n", totalTasks, totalNodes,
+           capacity > 0 ? totalSearch * 100.0 / capacity : 0.0);
+}
+
+// === PUNKTY KONTROLNE ===
+
+#define LEARN_CHECKPOINT_SECONDS 60
+#define LEARN_MAX_SEQUENCES 32
+
+static char learnCheckpointFile[256];
+static long long learnNextCheckpointMs = 0;
+static int learnCheckpointBusy = 0;
+static bool learnSequenceDone[LEARN_MAX_SEQUENCES];
+static int learnSequenceCount = 0;
+
+// Punkt kontrolny "opening_book_2.txt" -> "opening_book_2.txt.ckpt"
+static void setLearnCheckpoint(const char* filename) {
+    snprintf(learnCheckpointFile, sizeof(learnCheckpointFile), "%s.ckpt", filename);
+    learnNextCheckpointMs = (long long)(nowSeconds() * 1000) + LEARN_CHECKPOINT_SECONDS * 1000;
+}
+
+// Książka w formacie tekstowym (tablica + wpisy z buforów wątków) i stan kolejki pracy w nagłówku.
+// Bufory są czytane bez zatrzymywania wątków uczenia, a plik jest podmieniany atomowo.
+static bool writeLearnCheckpoint(const char* progress) {
+    int threads = bookBufferCount;
+    int* counts = calloc(threads + 1, sizeof(int));
+    OpeningEntry** buffers = calloc(threads + 1, sizeof(OpeningEntry*));
+    if (!counts || !buffers) {
+        printf("[CHECKPOINT] Error: Cannot allocate memory for checkpoint!\n");
+        free(counts);
+        free(buffers);
+        return false;
+    }
+    int total = bookSize;
+    for (int t = 0; t < threads; t++) {
+        counts[t] = __atomic_load_n(&bookBuffers[t].count, __ATOMIC_ACQUIRE);
+        buffers[t] = __atomic_load_n(&bookBuffers[t].entries, __ATOMIC_ACQUIRE);
+        total += counts[t];
+    }
+
+    char tempName[300];
+    FILE* file = beginAtomicWrite(learnCheckpointFile, "w", tempName, sizeof(tempName));
+    if (!file) {
+        printf("[CHECKPOINT] Error: Cannot write %s\n", learnCheckpointFile);
+        free(counts);
+        free(buffers);
+        return false;
+    }
+    writeBookHeader(file, total);
+    fprintf(file, "%s\n\n", progress);
+    for (int i = 0; i < bookCapacity; i++) {
+        if (openingBook[i].key != 0 && openingBook[i].data != 0) {
+            writeBookLine(file, openingBook[i].key, openingBook[i].data);
         }
     }
-    
-    printf("[LEARN] Depth %d/%d: %s\n", depth, maxDepth, 
-           strlen(currentSequence) == 0 ? "(start)" : currentSequence);
-    
-    int bestMove = 0;
-    int bestScore = -100000;
-    bool foundWinningMove = false;
-    
-    // Przeszukaj wszystkie możliwe ruchy
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (board[i][j] == 0) {
-                int move = (i + 1) * 10 + (j + 1);
-                
-                // Wykonaj ruch
-                board[i][j] = currentPlayer;
-                
-                // Sprawdź czy to natychmiastowa wygrana
-                if (winCheck(currentPlayer)) {
-                    board[i][j] = 0;
-                    bestMove = move;
-                    bestScore = 10000;
-                    foundWinningMove = true;
-                    break;
-                }
-                
-                // Sprawdź czy to samobójczy ruch (3 w rzędzie)
-                if (loseCheck(currentPlayer)) {
-                    board[i][j] = 0;
-                    continue; // Pomiń ten ruch
-                }
-                
-                // Oceń pozycję za pomocą minimax
-                int score = minimax(searchDepth - 1, -100000, 100000, 3 - currentPlayer, false, currentPlayer);
-                
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestMove = move;
-                }
-                
-                board[i][j] = 0; // Cofnij ruch
-            }
+    for (int t = 0; t < threads; t++) {
+        for (int i = 0; i < counts[t]; i++) writeBookLine(file, buffers[t][i].key, buffers[t][i].data);
+    }
+    free(counts);
+    free(buffers);
+    if (!finishAtomicWrite(file, tempName, learnCheckpointFile, !ferror(file))) {
+        printf("[CHECKPOINT] Error: Cannot write %s\n", learnCheckpointFile);
+        return false;
+    }
+    printf("[CHECKPOINT] Saved %d entries to %s\n", total, learnCheckpointFile);
+    return true;
+}
+
+// Wywoływane po zakończonych zadaniach uczenia - zapisuje co najwyżej jeden wątek naraz
+static void maybeLearnCheckpoint(void) {
+    long long now = (long long)(nowSeconds() * 1000);
+    if (now < __atomic_load_n(&learnNextCheckpointMs, __ATOMIC_RELAXED)) return;
+    if (__atomic_exchange_n(&learnCheckpointBusy, 1, __ATOMIC_ACQUIRE)) return;
+
+    char progress[256] = "# Completed sequences:";
+    size_t length = strlen(progress);
+    for (int s = 0; s < learnSequenceCount && length < sizeof(progress) - 4; s++) {
+        if (__atomic_load_n(&learnSequenceDone[s], __ATOMIC_ACQUIRE)) {
+            length += snprintf(progress + length, sizeof(progress) - length, " %d", s);
         }
-        if (foundWinningMove) break;
     }
-    
-    // Dodaj do książki jeśli znaleziono ruch
-    if (bestMove != 0) {
-        addOpeningEntry(currentSequence, bestMove, bestScore, searchDepth);
-        
-        // KLUCZOWA ZMIANA: Eksploruj WSZYSTKIE możliwe ruchy przeciwnika
-        if (depth < maxDepth) {
-            // Przeszukaj wszystkie możliwe odpowiedzi przeciwnika
-            for (int i = 0; i < 5; i++) {
-                for (int j = 0; j < 5; j++) {
-                    if (board[i][j] == 0) {
-                        int responseMove = (i + 1) * 10 + (j + 1);
-                        
-                        // Wykonaj ruch przeciwnika
-                        board[i][j] = 3 - currentPlayer;
-                        
-                        // Sprawdź czy przeciwnik nie wygrał
-                        if (winCheck(3 - currentPlayer)) {
-                            board[i][j] = 0; // Cofnij ruch
-                            continue; // Pomiń - przeciwnik wygrał
-                        }
-                        
-                        // Sprawdź czy przeciwnik nie popełnił samobójstwa
-                        if (loseCheck(3 - currentPlayer)) {
-                            board[i][j] = 0; // Cofnij ruch
-                            continue; // Pomiń - błędny ruch przeciwnika
-                        }
-                        
-                        // Zbuduj nową sekwencję dla ruchu przeciwnika
-                        char newSequence[MAX_SEQUENCE_LENGTH];
-                        if (strlen(currentSequence) == 0) {
-                            sprintf(newSequence, "%d", responseMove);
-                        } else {
-                            sprintf(newSequence, "%s,%d", currentSequence, responseMove);
-                        }
-                        
-                        // Rekurencyjnie eksploruj naszą odpowiedź na ruch przeciwnika
-                        explorePosition(newSequence, currentPlayer, depth + 1, maxDepth, searchDepth);
-                        
-                        board[i][j] = 0; // Cofnij ruch przeciwnika
-                    }
-                }
-            }
+    writeLearnCheckpoint(progress);
+    __atomic_store_n(&learnNextCheckpointMs, (long long)(nowSeconds() * 1000) + LEARN_CHECKPOINT_SECONDS * 1000,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&learnCheckpointBusy, 0, __ATOMIC_RELEASE);
+}
+
+// Wznowienie: wpisy z punktu kontrolnego trafiają do książki, a zakończone sekwencje są pomijane
+static bool loadLearnCheckpoint(void) {
+    FILE* file = fopen(learnCheckpointFile, "r");
+    if (!file) {
+        printf("[RESUME] No checkpoint %s - starting from scratch\n", learnCheckpointFile);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "# Completed sequences:", 22) != 0) continue;
+        char* p = line + 22;
+        char* end;
+        for (long s = strtol(p, &end, 10); end != p; s = strtol(p, &end, 10)) {
+            if (s >= 0 && s < LEARN_MAX_SEQUENCES) learnSequenceDone[s] = true;
+            p = end;
         }
     }
+    fclose(file);
+    bool loaded = loadTextBook(learnCheckpointFile);
+    printf("[RESUME] Continuing from %s (%d positions already analyzed)\n", learnCheckpointFile, bookSize);
+    return loaded;
 }
 
-void learnOpenings(int maxDepth, int searchDepth, const char* filename) {
+// Pozycja przeanalizowana przed przerwaniem (wpis co najmniej tej głębokości) - ruch z książki
+// zamiast ponownego przeszukiwania. Tablica nie zmienia się w trakcie równoległej fazy uczenia.
+static bool findAnalyzedMove(const BitBoard* bb, int toMove, int depth, int* cell, int* score) {
+    int orientation;
+    uint64_t code = bbCanonicalCodeOriented(bb, toMove, &orientation);
+    OpeningEntry* entry = findOpeningEntry(code);
+    if (!entry || bookEntryDepth(entry->data) < depth) return false;
+    int found = bbSymInverse[orientation][bbMoveToCell(bookEntryMove(entry->data))];
+    if (bbCellOwner(bb, found) != 0) return false;
+    *cell = found;
+    *score = bookEntryScore(entry->data);
+    return true;
+}
+
+// === UCZENIE ===
+
+void learnOpenings(int maxDepth, int searchDepth, const char* filename, bool resume) {
     printf("\n=== OPENING BOOK LEARNING ===\n");
     printf("Max depth: %d (limited to %d moves)\n", maxDepth, MAX_OPENING_MOVES);
     printf("Search depth: %d\n", searchDepth);
@@ -486,8 +808,10 @@ void learnOpenings(int maxDepth, int searchDepth, const char* filename) {
     
 #ifdef _OPENMP
     printf("OpenMP threads: %d\n", omp_get_max_threads());
-    init_book_lock();
+    initBookBuffers(omp_get_max_threads());
+    learnStatsCount = omp_get_max_threads();
 #else
+    learnStatsCount = 1;
     printf("Single-threaded mode\n");
 #endif
     printf("This may take several minutes...\n\n");
@@ -499,7 +823,13 @@ void learnOpenings(int maxDepth, int searchDepth, const char* filename) {
     }
     
     initOpeningBook();
-    clearMoveHistory();
+    memset(learnSequenceDone, 0, sizeof(learnSequenceDone));
+    setLearnCheckpoint(filename);
+    if (resume) loadLearnCheckpoint();
+    learnTableReady = ttInit(&learnTable, LEARN_TT_MB);
+    learnStats = calloc(learnStatsCount, sizeof(LearnThreadStats));
+    if (!learnStats) learnStatsCount = 0;
+    double learnStart = nowSeconds();
     
     // KROK 1: Równoległa analiza pierwszych ruchów (najdroższe obliczenia)
     if (maxDepth >= 1) {
@@ -547,6 +877,7 @@ void learnOpenings(int maxDepth, int searchDepth, const char* filename) {
             {23, 33},  // środek -> środek
         };
         int numSequences = sizeof(predefinedSequences) / sizeof(predefinedSequences[0]);
+        learnSequenceCount = numSequences;
         
         printf("[PARALLEL] Will analyze %d representative sequences with %d threads...\n", numSequences, 
 #ifdef _OPENMP
@@ -559,31 +890,63 @@ void learnOpenings(int maxDepth, int searchDepth, const char* filename) {
         // Dodaj licznik postępu
         int completed = 0;
 
+        // Każda sekwencja jest zadaniem, a jej płytkie poddrzewa kolejnymi zadaniami
+        // (exploreRecursive) - wolne wątki podkradają pracę z niezbalansowanych poddrzew
 #ifdef _OPENMP
-        #pragma omp parallel for schedule(dynamic, 1)
+        #pragma omp parallel
+        #pragma omp single
 #endif
         for (int s = 0; s < numSequences; s++) {
-            printf("[PROGRESS] Starting sequence %d/%d: %d,%d\n", s+1, numSequences, 
-                   predefinedSequences[s][0], predefinedSequences[s][1]);
-            
-            exploreFromPredefinedSequence(predefinedSequences[s][0], predefinedSequences[s][1], maxDepth, searchDepth);
-            
+            if (learnSequenceDone[s]) {
+                printf("[RESUME] Skipping completed sequence %d/%d: %d,%d\n", s+1, numSequences,
+                       predefinedSequences[s][0], predefinedSequences[s][1]);
+                completed++;
+                continue;
+            }
 #ifdef _OPENMP
-            #pragma omp atomic
+            #pragma omp task firstprivate(s) shared(completed, predefinedSequences)
 #endif
-            completed++;
-            
-            printf("[PROGRESS] Completed %d/%d sequences (%.1f%%)\n", 
-                   completed, numSequences, (completed * 100.0) / numSequences);
+            {
+                printf("[PROGRESS] Starting sequence %d/%d: %d,%d\n", s+1, numSequences, 
+                       predefinedSequences[s][0], predefinedSequences[s][1]);
+                
+                exploreFromPredefinedSequence(predefinedSequences[s][0], predefinedSequences[s][1], maxDepth, searchDepth);
+                
+                int done;
+#ifdef _OPENMP
+                #pragma omp atomic capture
+#endif
+                done = ++completed;
+                
+                printf("[PROGRESS] Completed %d/%d sequences (%.1f%%)\n", 
+                       done, numSequences, (done * 100.0) / numSequences);
+                __atomic_store_n(&learnSequenceDone[s], true, __ATOMIC_RELEASE);
+                maybeLearnCheckpoint();
+            }
         }
     }
     
-    // Zapisz książkę
-    saveOpeningBook(filename);
+    if (learnStats) {
+        printLearnUtilization(nowSeconds() - learnStart);
+        free(learnStats);
+        learnStats = NULL;
+        learnStatsCount = 0;
+    }
     
-#ifdef _OPENMP
-    cleanup_book_lock();
-#endif
+    mergeBookBuffers();
+    
+    // Zapisz książkę - obie wersje, żeby stara binarna nie przesłaniała nowej tekstowej
+    saveOpeningBook(filename);
+    char binaryFile[256];
+    binaryBookName(filename, binaryFile, sizeof(binaryFile));
+    saveBinaryBook(binaryFile);
+    
+    if (learnTableReady) {
+        ttPrintStats(&learnTable);
+        ttFree(&learnTable);
+        learnTableReady = false;
+    }
+    remove(learnCheckpointFile);  // Książka zapisana - punkt kontrolny niepotrzebny
     
     printf("\n=== LEARNING COMPLETE ===\n");
     printf("Generated %d opening positions\n", bookSize);
@@ -599,19 +962,24 @@ void exploreFirstLevelParallel(int maxDepth, int searchDepth) {
     // 2. Gracz 2: jeśli 33 wolne to 33, jeśli zajęte to 22 (lewy górny róg)
     
     // Dodaj podstawowe ruchy do książki bez ciężkiej analizy
-    addOpeningEntryThreadSafe("", 33, 5000, 1);  // Pusty -> gracz 1 gra 33
+    BitBoard bb;
+    bbClear(&bb);
+    addOpeningEntry(&bb, 1, 33, 5000, 1);  // Pusty -> gracz 1 gra 33
     
     // Odpowiedzi gracza 2 na 33
-    addOpeningEntryThreadSafe("33", 14, 4000, 1);  // Jeśli gracz 1 zagrał 33, gracz 2 gra 14 
+    bbPlace(&bb, bbMoveToCell(33), 1);
+    addOpeningEntry(&bb, 2, 14, 4000, 1);  // Jeśli gracz 1 zagrał 33, gracz 2 gra 14 
+    bbRemove(&bb, bbMoveToCell(33), 1);
 
-    // Gdyby gracz 1 nie zagrał 33 (rzadkie), gracz 2 gra środek
+    // Gdyby gracz 1 nie zagrał 33 (rzadkie), gracz 2 gra środek.
+    // Symetryczne pierwsze ruchy trafiają w ten sam wpis.
     for (int i = 1; i <= 5; i++) {
         for (int j = 1; j <= 5; j++) {
             int move = i * 10 + j;
             if (move != 33) {  // Wszystkie pierwsze ruchy oprócz 33
-                char seq[10];
-                sprintf(seq, "%d", move);
-                addOpeningEntryThreadSafe(seq, 33, 4500, 1);  // Odpowiedź: środek
+                bbPlace(&bb, bbMoveToCell(move), 1);
+                addOpeningEntry(&bb, 2, 33, 4500, 1);  // Odpowiedź: środek
+                bbRemove(&bb, bbMoveToCell(move), 1);
             }
         }
     }
@@ -619,252 +987,30 @@ void exploreFirstLevelParallel(int maxDepth, int searchDepth) {
     printf("[FIRST LEVEL] Added %d predefined opening moves\n", bookSize);
 }
 
-// === LOKALNE WERSJE FUNKCJI (BEZ MUTEX) ===
-
-bool winCheckLocal(int localBoard[5][5], int player) {
-    for (int i = 0; i < 28; i++) {
-        if ((localBoard[win[i][0][0]][win[i][0][1]] == player) &&
-            (localBoard[win[i][1][0]][win[i][1][1]] == player) &&
-            (localBoard[win[i][2][0]][win[i][2][1]] == player) &&
-            (localBoard[win[i][3][0]][win[i][3][1]] == player)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-bool loseCheckLocal(int localBoard[5][5], int player) {
-    for (int i = 0; i < 48; i++) {
-        if ((localBoard[lose[i][0][0]][lose[i][0][1]] == player) &&
-            (localBoard[lose[i][1][0]][lose[i][1][1]] == player) &&
-            (localBoard[lose[i][2][0]][lose[i][2][1]] == player)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-int evaluateBoardLocal(int localBoard[5][5], int player) {
-    // Skopiuj logikę z heuristic.c ale używaj localBoard
-    int score = 0;
-    
-    // Preferuj środek planszy
-    if (localBoard[2][2] == player) score += 10;
-    
-    // Oceń pozycję na podstawie kontroli nad polami
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (localBoard[i][j] == player) {
-                // Punkty za kontrolę nad polami blisko środka
-                int distFromCenter = abs(i - 2) + abs(j - 2);
-                score += (5 - distFromCenter);
-            } else if (localBoard[i][j] == (3 - player)) {
-                // Ujemne punkty za kontrolę przeciwnika
-                int distFromCenter = abs(i - 2) + abs(j - 2);
-                score -= (5 - distFromCenter);
-            }
-        }
-    }
-    
-    return score;
-}
-
-int minimaxLocal(int localBoard[5][5], int depth, int alpha, int beta, int currentPlayer, bool maximizing, int player) {
-    // Sprawdź stany końcowe przed sprawdzaniem głębokości
-    if (winCheckLocal(localBoard, player)) return 10000;
-    if (winCheckLocal(localBoard, 3 - player)) return -10000;
-    if (loseCheckLocal(localBoard, player)) return -10000;
-    if (loseCheckLocal(localBoard, 3 - player)) return 10000;
-    
-    // Sprawdź głębokość
-    if (depth == 0) {
-        return evaluateBoardLocal(localBoard, player);
-    }
-    
-    int best;
-    if (maximizing) {
-        best = -100000;
-        bool hasLegalMove = false;
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 5; j++) {
-                if (localBoard[i][j] == 0) {
-                    localBoard[i][j] = currentPlayer;
-                    
-                    // Sprawdź czy ruch jest legalny
-                    bool isLegal = !(loseCheckLocal(localBoard, currentPlayer) && !winCheckLocal(localBoard, currentPlayer));
-                    
-                    if (isLegal) {
-                        hasLegalMove = true;
-                        int val = minimaxLocal(localBoard, depth - 1, alpha, beta, 3 - currentPlayer, false, player);
-                        localBoard[i][j] = 0;
-                        if (val > best) best = val;
-                        if (best > alpha) alpha = best;
-                        if (beta <= alpha) {
-                            return best; // Przycinanie alfa-beta
-                        }
-                    } else {
-                        localBoard[i][j] = 0; // Cofnij nielegalny ruch
-                    }
-                }
-            }
-        }
-        if (!hasLegalMove) return -10000;
-        return best;
-    } else {
-        best = 100000;
-        bool hasLegalMove = false;
-        for (int i = 0; i < 5; i++) {
-            for (int j = 0; j < 5; j++) {
-                if (localBoard[i][j] == 0) {
-                    localBoard[i][j] = currentPlayer;
-                    
-                    bool isLegal = !(loseCheckLocal(localBoard, currentPlayer) && !winCheckLocal(localBoard, currentPlayer));
-                    
-                    if (isLegal) {
-                        hasLegalMove = true;
-                        int val = minimaxLocal(localBoard, depth - 1, alpha, beta, 3 - currentPlayer, true, player);
-                        localBoard[i][j] = 0;
-                        if (val < best) best = val;
-                        if (best < beta) beta = best;
-                        if (beta <= alpha) {
-                            return best;
-                        }
-                    } else {
-                        localBoard[i][j] = 0;
-                    }
-                }
-            }
-        }
-        if (!hasLegalMove) return 10000;
-        return best;
-    }
-}
-
-// === FUNKCJE SYMETRII I ROTACJI ===
-
-// Konwersja ruch (row,col) -> int i odwrotnie
-typedef struct {
-    int row, col;
-} Position;
-
-Position moveToPosition(int move) {
-    Position pos;
-    pos.row = (move / 10) - 1;  // 0-4
-    pos.col = (move % 10) - 1;  // 0-4
-    return pos;
-}
-
-int positionToMove(Position pos) {
-    return (pos.row + 1) * 10 + (pos.col + 1);
-}
-
-// Transformacje symetrii dla pozycji 5x5
-Position rotate90(Position pos) {
-    return (Position){pos.col, 4 - pos.row};
-}
-
-Position rotate180(Position pos) {
-    return (Position){4 - pos.row, 4 - pos.col};
-}
-
-Position rotate270(Position pos) {
-    return (Position){4 - pos.col, pos.row};
-}
-
-Position flipHorizontal(Position pos) {
-    return (Position){pos.row, 4 - pos.col};
-}
-
-Position flipVertical(Position pos) {
-    return (Position){4 - pos.row, pos.col};
+// Kontekst przeszukiwania jednego wątku uczenia: pozycja startowa + wspólna tablica transpozycji
+static void initLearnContext(SearchContext* ctx) {
+    BitBoard bb;
+    bbFromBoard(&bb, board);
+    searchInit(ctx, learnTableReady ? &learnTable : NULL);
+    searchSetPosition(ctx, &bb);
 }
 
-Position flipDiagonal1(Position pos) {  // główna przekątna
-    return (Position){pos.col, pos.row};
-}
-
-Position flipDiagonal2(Position pos) {  // anty-przekątna
-    return (Position){4 - pos.col, 4 - pos.row};
-}
-
-// Tablica wszystkich transformacji
-typedef Position (*TransformFunc)(Position);
-TransformFunc transforms[8] = {
-    NULL,           // identność (brak transformacji)
-    rotate90,
-    rotate180, 
-    rotate270,
-    flipHorizontal,
-    flipVertical,
-    flipDiagonal1,
-    flipDiagonal2
-};
-
-// Transformuj sekwencję ruchów
-void transformSequence(const char* input, char* output, int transformIndex) {
-    if (transformIndex == 0 || transforms[transformIndex] == NULL) {
-        strcpy(output, input);
-        return;
-    }
-    
-    output[0] = '\0';
-    
-    if (strlen(input) == 0) {
-        return;  // Pusta sekwencja
-    }
-    
-    char tempInput[MAX_SEQUENCE_LENGTH];
-    strcpy(tempInput, input);
-    
-    char* token = strtok(tempInput, ",");
-    bool first = true;
-    
-    while (token != NULL) {
-        int move = atoi(token);
-        Position pos = moveToPosition(move);
-        Position newPos = transforms[transformIndex](pos);
-        int newMove = positionToMove(newPos);
-        
-        if (!first) strcat(output, ",");
-        char moveStr[10];
-        sprintf(moveStr, "%d", newMove);
-        strcat(output, moveStr);
-        first = false;
-        
-        token = strtok(NULL, ",");
-    }
-}
-
-// Transformuj pojedynczy ruch
-int transformMove(int move, int transformIndex) {
-    if (transformIndex == 0 || transforms[transformIndex] == NULL) {
-        return move;
-    }
-    
-    Position pos = moveToPosition(move);
-    Position newPos = transforms[transformIndex](pos);
-    return positionToMove(newPos);
-}
-
-// Znajdź kanoniczną (najmniejszą leksykograficznie) reprezentację sekwencji
-void getCanonicalSequence(const char* input, char* canonical, int* bestTransform) {
-    strcpy(canonical, input);
-    *bestTransform = 0;
-    
-    for (int t = 1; t < 8; t++) {
-        char transformed[MAX_SEQUENCE_LENGTH];
-        transformSequence(input, transformed, t);
-        
-        if (strcmp(transformed, canonical) < 0) {
-            strcpy(canonical, transformed);
-            *bestTransform = t;
-        }
-    }
+// Zadanie eksploracji poddrzewa: własny kontekst z kopią pozycji, wspólna tablica transpozycji
+static void exploreTask(BitBoard position, const char* sequence, int currentPlayer,
+                        int depth, int maxDepth, int searchDepth) {
+    LearnThreadStats* stats = learnThreadStats();
+    if (stats) stats->tasks++;
+    SearchContext ctx;
+    searchInit(&ctx, learnTableReady ? &learnTable : NULL);
+    searchSetPosition(&ctx, &position);
+    exploreRecursive(&ctx, sequence, currentPlayer, depth, maxDepth, searchDepth);
+    searchFlushStats(&ctx);
+    maybeLearnCheckpoint();
 }
 
 // Funkcja do eksploracji wszystkich pozycji zaczynających się od danego pierwszego ruchu
-// Funkcja rekurencyjna dla eksploracji głębszych poziomów (thread-safe)
-void exploreRecursive(int localBoard[5][5], const char* currentSequence, int currentPlayer, 
+// Funkcja rekurencyjna dla eksploracji głębszych poziomów (thread-safe - każde zadanie ma własny kontekst)
+void exploreRecursive(SearchContext* ctx, const char* currentSequence, int currentPlayer, 
                      int depth, int maxDepth, int searchDepth) {
     if (depth > maxDepth) return;
     
@@ -873,83 +1019,75 @@ void exploreRecursive(int localBoard[5][5], const char* currentSequence, int cur
     static int depth2_completed = 0;
     
     if (depth == 1) {
+        int completed;
 #ifdef _OPENMP
-        #pragma omp atomic
+        #pragma omp atomic capture
 #endif
-        depth1_completed++;
+        completed = ++depth1_completed;
         
-        if (depth1_completed % 10 == 0) {
+        if (completed % 10 == 0) {
             printf("[PROGRESS DEEP] Level 1: Completed %d positions, analyzing: %s\n", 
-                   depth1_completed, currentSequence);
+                   completed, currentSequence);
         }
     }
     
     if (depth == 2) {
+        int completed;
 #ifdef _OPENMP
-        #pragma omp atomic
+        #pragma omp atomic capture
 #endif
-        depth2_completed++;
+        completed = ++depth2_completed;
         
-        if (depth2_completed % 50 == 0) {
+        if (completed % 50 == 0) {
             printf("[PROGRESS DEEP] Level 2: Completed %d positions, current: %s\n", 
-                   depth2_completed, currentSequence);
+                   completed, currentSequence);
         }
     }
     
+    BitBoard* bb = &ctx->board;
+    
     // Znajdź najlepszy ruch dla aktualnego gracza
-    int bestMove = 0;
+    int bestCell = -1;
     int bestScore = -100000;
-    bool foundWinningMove = false;
+    
+    // Po wznowieniu pozycja może być już przeanalizowana
+    bool analyzed = findAnalyzedMove(bb, currentPlayer, searchDepth, &bestCell, &bestScore);
     
     // Przeszukaj wszystkie możliwe ruchy
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (localBoard[i][j] == 0) {
-                int move = (i + 1) * 10 + (j + 1);
-                
-                // Wykonaj ruch
-                localBoard[i][j] = currentPlayer;
-                
-                // Sprawdź czy to natychmiastowa wygrana
-                if (winCheckLocal(localBoard, currentPlayer)) {
-                    localBoard[i][j] = 0;
-                    bestMove = move;
-                    bestScore = 10000;
-                    foundWinningMove = true;
-                    break;
-                }
-                
-                // Sprawdź czy to samobójczy ruch (3 w rzędzie)
-                if (loseCheckLocal(localBoard, currentPlayer)) {
-                    localBoard[i][j] = 0;
-                    continue; // Pomiń ten ruch
-                }
-                
-                // Oceń pozycję za pomocą minimax z pełną głębokością
-                int score = minimaxLocal(localBoard, searchDepth - 1, -100000, 100000, 
-                                        3 - currentPlayer, false, currentPlayer);
-                
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestMove = move;
-                }
-                
-                localBoard[i][j] = 0; // Cofnij ruch
-            }
+    for (int cell = 0; cell < BB_CELLS && !analyzed; cell++) {
+        if (bbCellOwner(bb, cell) != 0) continue;
+        
+        // Sprawdź czy to natychmiastowa wygrana
+        if (bbWouldWin(bb, currentPlayer, cell)) {
+            bestCell = cell;
+            bestScore = 10000;
+            break;
+        }
+        
+        // Sprawdź czy to samobójczy ruch (3 w rzędzie)
+        if (bbWouldLose(bb, currentPlayer, cell)) {
+            continue; // Pomiń ten ruch
+        }
+        
+        // Oceń pozycję za pomocą minimax z pełną głębokością
+        bbPlace(bb, cell, currentPlayer);
+        int score = learnSearch(ctx, searchDepth - 1, 3 - currentPlayer, currentPlayer);
+        bbRemove(bb, cell, currentPlayer); // Cofnij ruch
+        
+        if (score > bestScore) {
+            bestScore = score;
+            bestCell = cell;
         }
-        if (foundWinningMove) break;
     }
     
     // Dodaj do książki jeśli znaleziono ruch
-    if (bestMove != 0) {
-        addOpeningEntryThreadSafe(currentSequence, bestMove, bestScore, searchDepth);
+    if (bestCell >= 0) {
+        if (!analyzed) bufferOpeningEntry(bb, currentPlayer, bbCellToMove(bestCell), bestScore, searchDepth);
         
         // OPTYMALIZACJA: Kontynuuj rekurencję tylko dla NAJLEPSZYCH 3-5 odpowiedzi przeciwnika
         if (depth < maxDepth) {
             // Wykonaj najlepszy ruch
-            int bestRow = (bestMove / 10) - 1;
-            int bestCol = (bestMove % 10) - 1;
-            localBoard[bestRow][bestCol] = currentPlayer;
+            bbPlace(bb, bestCell, currentPlayer);
             
             // Znajdź najlepsze odpowiedzi przeciwnika (max 5 zamiast wszystkich 20+)
             typedef struct {
@@ -959,80 +1097,76 @@ void exploreRecursive(int localBoard[5][5], const char* currentSequence, int cur
             
             MoveScore topMoves[8]; // Top 8 ruchów przeciwnika
             int topCount = 0;
-            int candidatesEvaluated = 0;
             
             // Oceń wszystkie możliwe odpowiedzi
-            for (int i = 0; i < 5; i++) {
-                for (int j = 0; j < 5; j++) {
-                    if (localBoard[i][j] == 0) {
-                        int responseMove = (i + 1) * 10 + (j + 1);
-                        candidatesEvaluated++;
-                        
-                        // Progress dla preselekcji (która jest najwolniejsza)
-                        if (depth <= 2) {
-                            printf("[MINIMAX EVAL] Depth %d: Evaluating candidate move %d (%d) for sequence: %s\n", 
-                                   depth, candidatesEvaluated, responseMove, currentSequence);
-                        }
-                        
-                        // Wykonaj ruch przeciwnika
-                        localBoard[i][j] = 3 - currentPlayer;
-                        
-                        // Sprawdź czy przeciwnik nie wygrał lub popełnił błąd
-                        if (winCheckLocal(localBoard, 3 - currentPlayer) || 
-                            loseCheckLocal(localBoard, 3 - currentPlayer)) {
-                            localBoard[i][j] = 0; // Cofnij ruch
-                            continue; // Pomiń ten ruch
-                        }
-                        
-                        // Oceń pozycję z większą głębokością (połowa pełnej głębokości)
-                        int preselectDepth = searchDepth / 2;
-                        if (preselectDepth < 3) preselectDepth = 3;
-                         int score = minimaxLocal(localBoard, preselectDepth, -100000, 100000, 
-                                                currentPlayer, true, 3 - currentPlayer);
-
-                        // Dodaj do top 8 jeśli warto
-                        if (topCount < 8) {
-                            topMoves[topCount].move = responseMove;
-                            topMoves[topCount].score = score;
-                            topCount++;
-                        } else {
-                            // Znajdź najgorszy z top 8 i zastąp jeśli lepszy
-                            int worstIdx = 0;
-                            for (int k = 1; k < 8; k++) {
-                                if (topMoves[k].score < topMoves[worstIdx].score) {
-                                    worstIdx = k;
-                                }
-                            }
-                            if (score > topMoves[worstIdx].score) {
-                                topMoves[worstIdx].move = responseMove;
-                                topMoves[worstIdx].score = score;
-                            }
+            for (int cell = 0; cell < BB_CELLS; cell++) {
+                if (bbCellOwner(bb, cell) != 0) continue;
+                int responseMove = bbCellToMove(cell);
+                
+                // Sprawdź czy przeciwnik nie wygrał lub popełnił błąd
+                if (bbWouldWin(bb, 3 - currentPlayer, cell) || 
+                    bbWouldLose(bb, 3 - currentPlayer, cell)) {
+                    continue; // Pomiń ten ruch
+                }
+                
+                // Oceń odpowiedź z perspektywy przeciwnika (połowa pełnej głębokości);
+                // po jego ruchu rusza się aktualny gracz, więc węzeł jest minimalizujący
+                int preselectDepth = searchDepth / 2;
+                if (preselectDepth < 3) preselectDepth = 3;
+                bbPlace(bb, cell, 3 - currentPlayer);
+                int score = learnSearch(ctx, preselectDepth, currentPlayer, 3 - currentPlayer);
+                bbRemove(bb, cell, 3 - currentPlayer); // Cofnij ruch przeciwnika
+
+                // Dodaj do top 8 jeśli warto
+                if (topCount < 8) {
+                    topMoves[topCount].move = responseMove;
+                    topMoves[topCount].score = score;
+                    topCount++;
+                } else {
+                    // Znajdź najgorszy z top 8 i zastąp jeśli lepszy
+                    int worstIdx = 0;
+                    for (int k = 1; k < 8; k++) {
+                        if (topMoves[k].score < topMoves[worstIdx].score) {
+                            worstIdx = k;
                         }
-                        
-                        localBoard[i][j] = 0; // Cofnij ruch przeciwnika
+                    }
+                    if (score > topMoves[worstIdx].score) {
+                        topMoves[worstIdx].move = responseMove;
+                        topMoves[worstIdx].score = score;
                     }
                 }
             }
             
-            // Rekurencyjnie eksploruj tylko top ruchy
+            // Rekurencyjnie eksploruj tylko top ruchy - płytkie poddrzewa jako osobne zadania
             for (int t = 0; t < topCount; t++) {
                 int responseMove = topMoves[t].move;
-                int row = (responseMove / 10) - 1;
-                int col = (responseMove % 10) - 1;
+                int cell = bbMoveToCell(responseMove);
                 
-                localBoard[row][col] = 3 - currentPlayer;
+                bbPlace(bb, cell, 3 - currentPlayer);
                 
                 char newSequence[MAX_SEQUENCE_LENGTH];
                 sprintf(newSequence, "%s,%d", currentSequence, responseMove);
                 
-                exploreRecursive(localBoard, newSequence, currentPlayer, 
-                               depth + 1, maxDepth, searchDepth);
+                if (depth < LEARN_SPAWN_DEPTH) {
+                    BitBoard child = *bb;
+#ifdef _OPENMP
+                    #pragma omp task firstprivate(child, newSequence)
+#endif
+                    exploreTask(child, newSequence, currentPlayer, depth + 1, maxDepth, searchDepth);
+                } else {
+                    exploreRecursive(ctx, newSequence, currentPlayer, 
+                                   depth + 1, maxDepth, searchDepth);
+                }
                 
-                localBoard[row][col] = 0;
+                bbRemove(bb, cell, 3 - currentPlayer);
             }
+            // Poddrzewa muszą być gotowe przed zakończeniem węzła (wątek czekając wykonuje inne zadania)
+#ifdef _OPENMP
+            #pragma omp taskwait
+#endif
             
             // Cofnij najlepszy ruch
-            localBoard[bestRow][bestCol] = 0;
+            bbRemove(bb, bestCell, currentPlayer);
         }
     }
 }
@@ -1040,49 +1174,35 @@ void exploreRecursive(int localBoard[5][5], const char* currentSequence, int cur
 void exploreFromFirstMove(int firstMove, int maxDepth, int searchDepth) {
     if (maxDepth < 2) return;
     
-    int row = (firstMove / 10) - 1;
-    int col = (firstMove % 10) - 1;
-    
-    // Każdy wątek ma własną kopię planszy
-    int localBoard[5][5];
-    memcpy(localBoard, board, sizeof(board));
-    localBoard[row][col] = 1;  // Pierwszy ruch
-    
-    char firstSequence[5];
-    sprintf(firstSequence, "%d", firstMove);
+    // Każdy wątek ma własny kontekst przeszukiwania
+    SearchContext ctx;
+    initLearnContext(&ctx);
+    bbPlace(&ctx.board, bbMoveToCell(firstMove), 1);  // Pierwszy ruch
     
     // Analizuj wszystkie możliwe odpowiedzi przeciwnika (gracz 2)
-    for (int i = 0; i < 5; i++) {
-        for (int j = 0; j < 5; j++) {
-            if (localBoard[i][j] == 0) {
-                int secondMove = (i + 1) * 10 + (j + 1);
-                
-                // Wykonaj drugi ruch na lokalnej planszy
-                localBoard[i][j] = 2;
-                
-                // Sprawdź czy to nie natychmiastowa wygrana/przegrana
-                bool skipMove = false;
-                
-                if (winCheckLocal(localBoard, 2)) {
-                    skipMove = true;  // Przeciwnik wygrał
-                } else if (loseCheckLocal(localBoard, 2)) {
-                    skipMove = true;  // Przeciwnik popełnił samobójczy ruch
-                }
-                
-                if (!skipMove) {
-                    // Zbuduj sekwencję dwóch ruchów
-                    char sequence[50];
-                    sprintf(sequence, "%d,%d", firstMove, secondMove);
-                    
-                    // Użyj funkcji rekurencyjnej dla dalszej eksploracji
-                    exploreRecursive(localBoard, sequence, 1, 2, maxDepth, searchDepth);
-                }
-                
-                // Cofnij drugi ruch
-                localBoard[i][j] = 0;
-            }
+    for (int cell = 0; cell < BB_CELLS; cell++) {
+        if (bbCellOwner(&ctx.board, cell) != 0) continue;
+        int secondMove = bbCellToMove(cell);
+        
+        // Pomiń natychmiastową wygraną przeciwnika i jego samobójczy ruch
+        if (bbWouldWin(&ctx.board, 2, cell) || bbWouldLose(&ctx.board, 2, cell)) {
+            continue;
         }
+        
+        // Wykonaj drugi ruch w kontekście
+        bbPlace(&ctx.board, cell, 2);
+        
+        // Zbuduj sekwencję dwóch ruchów
+        char sequence[50];
+        sprintf(sequence, "%d,%d", firstMove, secondMove);
+        
+        // Użyj funkcji rekurencyjnej dla dalszej eksploracji
+        exploreRecursive(&ctx, sequence, 1, 2, maxDepth, searchDepth);
+        
+        // Cofnij drugi ruch
+        bbRemove(&ctx.board, cell, 2);
     }
+    searchFlushStats(&ctx);
 }
 
 // Eksploruje dalsze ruchy dla predefiniowanej sekwencji 2 ruchów
@@ -1091,24 +1211,181 @@ void exploreFromPredefinedSequence(int firstMove, int secondMove, int maxDepth,
     
     printf("[DEEP ANALYSIS] Exploring from sequence %d,%d to depth %d\n", firstMove, secondMove, maxDepth);
     
-    // Przygotuj planszę z dwoma pierwszymi ruchami
-    int localBoard[5][5];
-    memcpy(localBoard, board, sizeof(board));
-    
-    // Wykonaj pierwszy ruch (gracz 1)
-    int row1 = (firstMove / 10) - 1;
-    int col1 = (firstMove % 10) - 1;
-    localBoard[row1][col1] = 1;
-    
-    // Wykonaj drugi ruch (gracz 2)  
-    int row2 = (secondMove / 10) - 1;
-    int col2 = (secondMove % 10) - 1;
-    localBoard[row2][col2] = 2;
+    // Przygotuj kontekst z dwoma pierwszymi ruchami
+    LearnThreadStats* stats = learnThreadStats();
+    if (stats) stats->tasks++;
+    SearchContext ctx;
+    initLearnContext(&ctx);
+    bbPlace(&ctx.board, bbMoveToCell(firstMove), 1);   // Pierwszy ruch (gracz 1)
+    bbPlace(&ctx.board, bbMoveToCell(secondMove), 2);  // Drugi ruch (gracz 2)
     
     // Zbuduj sekwencję startową
     char startSequence[50];
     sprintf(startSequence, "%d,%d", firstMove, secondMove);
     
     // Rozpocznij rekurencyjną eksplorację od trzeciego ruchu (gracz 1)
-    exploreRecursive(localBoard, startSequence, 1, 2, maxDepth, searchDepth);
+    exploreRecursive(&ctx, startSequence, 1, 2, maxDepth, searchDepth);
+    searchFlushStats(&ctx);
+}
+
+// === PEŁNA KSIĄŻKA ===
+
+// Pozycja z kodu (kamienie gracza na ruchu | kamienie przeciwnika << 25). Kamienie są stawiane
+// przez bbPlace, żeby kody linii i liczniki kształtów oceny były aktualne.
+static void codeToBoard(uint64_t code, int toMove, BitBoard* bb) {
+    bbClear(bb);
+    for (uint32_t m = (uint32_t)(code & BB_FULL); m; m &= m - 1) bbPlace(bb, __builtin_ctz(m), toMove);
+    for (uint32_t m = (uint32_t)(code >> BB_CELLS); m; m &= m - 1) bbPlace(bb, __builtin_ctz(m), 3 - toMove);
+}
+
+static void pushBookCode(uint64_t** codes, int* count, int* capacity, uint64_t code) {
+    if (*count == *capacity) {
+        int grown = *capacity ? *capacity * 2 : 1024;
+        uint64_t* list = realloc(*codes, grown * sizeof(uint64_t));
+        if (!list) {
+            printf("Error: Cannot allocate memory for full book generation!\n");
+            exit(1);
+        }
+        *codes = list;
+        *capacity = grown;
+    }
+    (*codes)[(*count)++] = code;
+}
+
+static int compareBookCodes(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Pełna książka dla pierwszych 'plies' ruchów: warstwa po warstwie wszystkie pozycje kanoniczne
+// osiągalne dowolną grą obu stron. Każda pozycja warstwy jest analizowana równolegle tym samym
+// wyborem ruchu co w grze (searchBestMove), a jej potomkowie (bez ruchów kończących grę) tworzą
+// następną warstwę. Kody kanoniczne scalają transpozycje i symetrie; pozycje z rozstrzygniętą
+// oceną (wygrana lub przegrana gracza na ruchu) nie są rozwijane. Warstwa jest liczona porcjami
+// - między porcjami zapisywany jest punkt kontrolny, a po wznowieniu pozycje z książki są pomijane
+// (kolejna warstwa powstaje z nich bez przeszukiwania).
+#define FULL_BOOK_CHUNK 4096
+
+void generateFullBook(int plies, int searchDepth, const char* filename, bool resume) {
+    printf("\n=== FULL OPENING BOOK GENERATION ===\n");
+    if (plies > MAX_OPENING_MOVES) {
+        plies = MAX_OPENING_MOVES;
+        printf("[FULL BOOK] Limited plies to %d (MAX_OPENING_MOVES)\n", plies);
+    }
+    printf("Plies: %d, search depth: %d, output: %s\n", plies, searchDepth, filename);
+#ifdef _OPENMP
+    printf("OpenMP threads: %d\n", omp_get_max_threads());
+#endif
+
+    initOpeningBook();
+    learnSequenceCount = 0;
+    setLearnCheckpoint(filename);
+    if (resume) loadLearnCheckpoint();
+    learnTableReady = ttInit(&learnTable, LEARN_TT_MB);
+    SearchLimits limits = { searchDepth, 0, 1, 0, false, false };
+
+    uint64_t* level = NULL;
+    int levelCount = 0, levelCapacity = 0;
+    pushBookCode(&level, &levelCount, &levelCapacity, 0);  // Pusta plansza, rusza się gracz 1
+    double start = nowSeconds();
+
+    for (int ply = 0; ply < plies && levelCount > 0; ply++) {
+        double levelStart = nowSeconds();
+        int toMove = (ply % 2 == 0) ? 1 : 2;
+        bool expand = ply + 1 < plies;
+        uint64_t* next = NULL;
+        int nextCount = 0, nextCapacity = 0;
+        int decided = 0, reused = 0;
+
+        // Miejsce na całą warstwę z góry - wstawianie z wielu wątków bez powiększania tablicy
+        reserveOpeningBook(bookSize + levelCount);
+        for (int chunk = 0; chunk < levelCount; chunk += FULL_BOOK_CHUNK) {
+            int chunkEnd = (chunk + FULL_BOOK_CHUNK < levelCount) ? chunk + FULL_BOOK_CHUNK : levelCount;
+    #ifdef _OPENMP
+            #pragma omp parallel
+    #endif
+            {
+                SearchContext ctx;
+                searchInit(&ctx, learnTableReady ? &learnTable : NULL);
+                uint64_t* local = NULL;
+                int localCount = 0, localCapacity = 0;
+
+    #ifdef _OPENMP
+                #pragma omp for schedule(dynamic, 16) reduction(+:decided, reused)
+    #endif
+                for (int i = chunk; i < chunkEnd; i++) {
+                    BitBoard bb;
+                    codeToBoard(level[i], toMove, &bb);
+                    SearchResult result = { 0, 0, 0, 0 };
+                    int cell;
+                    if (findAnalyzedMove(&bb, toMove, searchDepth, &cell, &result.score)) {
+                        result.move = bbCellToMove(cell);  // Przeanalizowana przed wznowieniem
+                        reused++;
+                    } else {
+                        searchSetPosition(&ctx, &bb);
+                        result = searchBestMove(&ctx, toMove, &limits);
+                        if (result.move == 0) continue;
+                        addCanonicalEntry(level[i], result.move, result.score, searchDepth);
+                    }
+                    if (result.score >= 10000 || result.score <= -10000) {
+                        decided++;  // Linia rozstrzygnięta - dalsze ruchy nie są potrzebne w książce
+                        continue;
+                    }
+                    if (!expand) continue;
+                    for (uint32_t e = bbEmpty(&bb); e; e &= e - 1) {
+                        int cell = __builtin_ctz(e);
+                        if (bbWouldWin(&bb, toMove, cell) || bbWouldLose(&bb, toMove, cell)) continue;  // Koniec gry
+                        bbPlace(&bb, cell, toMove);
+                        pushBookCode(&local, &localCount, &localCapacity, bbCanonicalCode(&bb, 3 - toMove));
+                        bbRemove(&bb, cell, toMove);
+                    }
+                }
+
+    #ifdef _OPENMP
+                #pragma omp critical
+    #endif
+                for (int i = 0; i < localCount; i++) {
+                    pushBookCode(&next, &nextCount, &nextCapacity, local[i]);
+                }
+                free(local);
+                searchFlushStats(&ctx);
+            }
+
+            if ((long long)(nowSeconds() * 1000) >= learnNextCheckpointMs) {
+                char progress[128];
+                snprintf(progress, sizeof(progress), "# Checkpoint: full book ply %d, %d/%d positions", ply, chunkEnd,
+                         levelCount);
+                writeLearnCheckpoint(progress);
+                learnNextCheckpointMs = (long long)(nowSeconds() * 1000) + LEARN_CHECKPOINT_SECONDS * 1000;
+            }
+        }
+
+        // Transpozycje i symetrie dają ten sam kod - każda pozycja następnej warstwy raz
+        qsort(next, nextCount, sizeof(uint64_t), compareBookCodes);
+        int unique = 0;
+        for (int i = 0; i < nextCount; i++) {
+            if (unique == 0 || next[i] != next[unique - 1]) next[unique++] = next[i];
+        }
+        printf("[FULL BOOK] ply %d: positions=%d decided=%d reused=%d next=%d (from %d moves) %.1f s\n",
+               ply, levelCount, decided, reused, unique, nextCount, nowSeconds() - levelStart);
+        free(level);
+        level = next;
+        levelCount = unique;
+    }
+    free(level);
+
+    saveOpeningBook(filename);
+    char binaryFile[256];
+    binaryBookName(filename, binaryFile, sizeof(binaryFile));
+    saveBinaryBook(binaryFile);
+
+    if (learnTableReady) {
+        ttPrintStats(&learnTable);
+        ttFree(&learnTable);
+        learnTableReady = false;
+    }
+    remove(learnCheckpointFile);
+    printf("\n=== FULL BOOK COMPLETE ===\n");
+    printf("Generated %d positions for the first %d plies in %.1f s\n", bookSize, plies, nowSeconds() - start);
+    printf("Book saved to: %s\n", filename);
 }
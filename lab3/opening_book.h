@@ -2,77 +2,92 @@
 #define OPENING_BOOK_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "search.h"
 
 #define MAX_OPENING_MOVES 10
 #define MAX_SEQUENCE_LENGTH 100
-#define MAX_BOOK_ENTRIES 10000
-#define HASH_TABLE_SIZE 100003  // Liczba pierwsza dla lepszego hash'owania
+#define BOOK_MAGIC "WSIBK01"
 
-// Struktura wpisu w książce otwarć
+#define BOOK_INITIAL_CAPACITY 1024  // Najmniejsza liczba slotów
+#define BOOK_KEY_USED (1ull << 63)  // Znacznik zajętego slotu (kod pozycji ma 50 bitów)
+
+// Struktura wpisu w książce otwarć (16 bajtów). Kluczem jest pozycja, a nie sekwencja ruchów:
+// jeden wpis obejmuje wszystkie kolejności ruchów i wszystkie 8 symetrii.
+// Książka to jedna tablica z adresowaniem otwartym w jednym bloku pamięci - wpis jest slotem
+// tablicy, bez alokacji na wpis i bez wskaźników.
 typedef struct {
-    char sequence[MAX_SEQUENCE_LENGTH];  // "33,22,43" - sekwencja ruchów
-    int best_move;                       // Najlepszy ruch dla tej sekwencji
-    int score;                          // Ocena minimax dla tego ruchu
-    int depth_analyzed;                 // Głębokość analizy użyta
+    uint64_t key;       // Kod kanoniczny pozycji | BOOK_KEY_USED (0 = wolny slot)
+    uint64_t data;      // Ocena (32 bity) | ruch w orientacji kanonicznej << 32 | głębokość << 40
 } OpeningEntry;
 
-// Struktura węzła hash table
-typedef struct HashNode {
-    char sequence[MAX_SEQUENCE_LENGTH];
-    int best_move;
-    int score;
-    int depth_analyzed;
-    struct HashNode* next;  // Dla obsługi kolizji (chaining)
-} HashNode;
+static inline uint64_t bookPackData(int move, int score, int depth) {
+    return (uint64_t)(uint32_t)score | ((uint64_t)(uint8_t)move << 32) | ((uint64_t)(uint8_t)depth << 40);
+}
+
+static inline int bookEntryScore(uint64_t data) { return (int32_t)(uint32_t)data; }
+static inline int bookEntryMove(uint64_t data) { return (int)((data >> 32) & 0xFF); }
+static inline int bookEntryDepth(uint64_t data) { return (int)((data >> 40) & 0xFF); }
+
+// Wpis binarnej książki (plik .bin obok pliku tekstowego). Plik: BookHeader + wpisy
+// posortowane rosnąco po kodzie - odczyt przez mmap i wyszukiwanie binarne, bez parsowania.
+typedef struct {
+    uint64_t code;      // Kod kanoniczny pozycji (bbCanonicalCode dla gracza na ruchu)
+    int32_t score;
+    uint8_t cell;       // Pole ruchu w orientacji kanonicznej
+    uint8_t depth;
+    uint16_t reserved;
+} BookEntry;
+
+typedef struct {
+    char magic[8];
+    uint64_t count;
+} BookHeader;
 
 // === GŁÓWNE FUNKCJE ===
 
 // Ładowanie/zapisywanie książki
-bool loadOpeningBook(const char* filename);
+bool loadOpeningBook(const char* filename);  // Najpierw wersja .bin, potem tekstowa
 void saveOpeningBook(const char* filename);
+bool saveBinaryBook(const char* filename);
+bool loadBinaryBook(const char* filename);
+bool convertOpeningBook(const char* textFile);  // Tekst -> .bin (ta sama nazwa z rozszerzeniem .bin)
 
-// Użycie książki w grze
-int getOpeningMove(const char* moveSequence, int moveCount);
+// Użycie książki w grze: ruch dla gracza 'toMove' w pozycji 'bb' (0 = brak w książce)
+int getOpeningMove(const BitBoard* bb, int toMove);
 bool isInOpeningPhase(int moveCount);
 
 // Auto-uczenie książki
-void learnOpenings(int maxDepth, int searchDepth, const char* filename);
+// resume = true: wznowienie z punktu kontrolnego <filename>.ckpt (zapisywanego co minutę)
+void learnOpenings(int maxDepth, int searchDepth, const char* filename, bool resume);
 void exploreFirstLevelParallel(int maxDepth, int searchDepth);  // Parallel learning
 void exploreFromFirstMove(int firstMove, int maxDepth, int searchDepth);  // Parallel deeper analysis
 void exploreFromPredefinedSequence(int firstMove, int secondMove, int maxDepth, int searchDepth);  // Deep analysis from 2-move sequence
-void exploreRecursive(int localBoard[5][5], const char* currentSequence, int currentPlayer, 
+void exploreRecursive(SearchContext* ctx, const char* currentSequence, int currentPlayer, 
                      int depth, int maxDepth, int searchDepth);  // Thread-safe recursive exploration
 
+// Pełna książka: wszystkie pozycje kanoniczne z pierwszych 'plies' ruchów (dowolna gra obu stron)
+void generateFullBook(int plies, int searchDepth, const char* filename, bool resume);
+
 // === FUNKCJE POMOCNICZE ===
 
-// Zarządzanie historią ruchów
-void clearMoveHistory(void);
-void addMoveToHistory(int move);
-char* buildMoveSequence(void);
-int getMoveCount(void);
+// Pozycja po sekwencji ruchów "33,22,43" (wczytywanie starszych książek)
+bool sequenceToBoard(const char* sequence, BitBoard* bb, int* toMove);
 
 // Zarządzanie książką
 void initOpeningBook(void);
-void addOpeningEntry(const char* sequence, int move, int score, int depth);
+void reserveOpeningBook(int entries);  // Rozmiar tablicy dla podanej liczby pozycji
+void addOpeningEntry(const BitBoard* bb, int toMove, int move, int score, int depth);
+void addCanonicalEntry(uint64_t code, int canonicalMove, int score, int depth);
+OpeningEntry* findOpeningEntry(uint64_t code);
 void freeOpeningBook(void);
 
-// Hash table functions (wewnętrzne - dla optymalizacji)
-void initHashTable(void);
-void addToHashTable(const char* sequence, int move, int score, int depth);
-HashNode* findInHashTable(const char* sequence);
-void freeHashTable(void);
-unsigned int hash(const char* str);
-
-// Funkcje symetrii i rotacji (optymalizacja przez redukcję pozycji)
-void getCanonicalSequence(const char* input, char* canonical, int* bestTransform);
-void transformSequence(const char* input, char* output, int transformIndex);
-int transformMove(int move, int transformIndex);
+// Pomiar czasu wstawiania, zapisu, wczytania i wyszukiwania dla książek do maxEntries pozycji
+void benchmarkOpeningBook(int maxEntries);
 
 // === ZMIENNE GLOBALNE ===
-extern OpeningEntry* openingBook;
-extern int bookSize;
+extern OpeningEntry* openingBook;  // Sloty tablicy (bookCapacity)
+extern int bookSize;                // Liczba zajętych slotów
 extern int bookCapacity;
-extern int moveHistory[25];  // Historia ruchów (max 25 w grze 5x5)
-extern int historyLength;
 
 #endif // OPENING_BOOK_H
@@ -0,0 +1,575 @@
+#include "search.h"
+#include "heuristic.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// === KONTEKST ===
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void searchInit(SearchContext* ctx, TranspositionTable* tt) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->tt = tt;
+    ctx->stop = NULL;
+    ctx->startTime = nowSeconds();
+}
+
+void searchSetPosition(SearchContext* ctx, const BitBoard* bb) {
+    ctx->board = *bb;
+}
+
+void searchClearHistory(SearchContext* ctx) {
+    memset(ctx->killerMoves, 0, sizeof(ctx->killerMoves));
+    memset(ctx->historyScore, 0, sizeof(ctx->historyScore));
+}
+
+// Między ruchami jednej gry: killery są indeksowane liczbą kamieni, więc nadal pasują do pozycji;
+// historia traci połowę wagi, żeby nowe odcięcia szybko ją przeważyły
+void searchAgeHistory(SearchContext* ctx) {
+    for (int p = 1; p <= 2; p++) {
+        for (int c = 0; c < BB_CELLS; c++) {
+            ctx->historyScore[p][c] /= 2;
+        }
+    }
+}
+
+// Start pomiaru czasu (0 ms = bez limitu) - zeruje też licznik węzłów.
+// Po przekroczeniu limitu searchMinimax zwraca 0, a searchTimedOut() zwraca true -
+// wynik takiej iteracji należy odrzucić.
+void searchStartTimer(SearchContext* ctx, int timeLimitMs) {
+    ctx->startTime = nowSeconds();
+    ctx->deadline = (timeLimitMs > 0) ? ctx->startTime + timeLimitMs / 1000.0 : 0.0;
+    ctx->aborted = false;
+    ctx->stats.nodes = 0;
+}
+
+bool searchTimedOut(const SearchContext* ctx) {
+    return ctx->aborted;
+}
+
+double searchElapsedMs(const SearchContext* ctx) {
+    return (nowSeconds() - ctx->startTime) * 1000.0;
+}
+
+void searchPollStop(SearchContext* ctx) {
+    if ((ctx->stop && atomic_load_explicit(ctx->stop, memory_order_relaxed)) ||
+        (ctx->deadline > 0.0 && nowSeconds() >= ctx->deadline)) {
+        ctx->aborted = true;
+    }
+}
+
+void searchFlushStats(SearchContext* ctx) {
+    if (ctx->tt) {
+        __atomic_fetch_add(&ctx->tt->probes, ctx->stats.ttProbes, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->tt->hits, ctx->stats.ttHits, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->tt->cutoffs, ctx->stats.ttCutoffs, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->tt->stores, ctx->stats.ttStores, __ATOMIC_RELAXED);
+    }
+    ctx->stats.ttProbes = ctx->stats.ttHits = ctx->stats.ttCutoffs = ctx->stats.ttStores = 0;
+}
+
+// === KOLEJNOŚĆ RUCHÓW ===
+
+#define HISTORY_LIMIT (1 << 20)
+
+// Priorytety klas ruchów (powyżej dowolnej wartości historii)
+#define ORDER_TT_MOVE    (1 << 30)
+#define ORDER_WIN        (1 << 29)
+#define ORDER_BLOCK      (1 << 28)
+#define ORDER_KILLER     (1 << 27)
+
+typedef struct {
+    int cells[BB_CELLS];
+    int scores[BB_CELLS];
+    bool wins[BB_CELLS];
+    int count;
+} MoveList;
+
+// Generuje legalne ruchy z priorytetami: ruch z tablicy transpozycji, natychmiastowe wygrane,
+// blokady pola, na którym przeciwnik dokończyłby 4 w rzędzie, killery tego ply, historia.
+// Ruchy tworzące 3 w rzędzie bez 4 w rzędzie są samobójcze i nie trafiają na listę.
+static void orderMoves(const SearchContext* ctx, int currentPlayer, int ttCell, MoveList* list) {
+    const BitBoard* bb = &ctx->board;
+    int ply = __builtin_popcount(bb->stones[1] | bb->stones[2]);
+    uint32_t empty = bbEmpty(bb);
+    list->count = 0;
+    while (empty) {
+        int cell = __builtin_ctz(empty);
+        empty &= empty - 1;
+
+        bool won = bbWouldWin(bb, currentPlayer, cell);
+        if (!won && bbWouldLose(bb, currentPlayer, cell)) continue;
+
+        int score = ctx->historyScore[currentPlayer][cell];
+        if (cell == ttCell) score = ORDER_TT_MOVE;
+        else if (won) score = ORDER_WIN;
+        else if (bbWouldWin(bb, 3 - currentPlayer, cell)) score = ORDER_BLOCK;
+        else if (cell + 1 == ctx->killerMoves[ply][0]) score = ORDER_KILLER + 1;
+        else if (cell + 1 == ctx->killerMoves[ply][1]) score = ORDER_KILLER;
+
+        list->cells[list->count] = cell;
+        list->scores[list->count] = score;
+        list->wins[list->count] = won;
+        list->count++;
+    }
+}
+
+// Sortowanie przez wybór na bieżąco - po odcięciu reszta listy nie jest sortowana
+static inline void pickNextMove(MoveList* list, int k) {
+    int bestIndex = k;
+    for (int i = k + 1; i < list->count; i++) {
+        if (list->scores[i] > list->scores[bestIndex]) bestIndex = i;
+    }
+    if (bestIndex != k) {
+        int cell = list->cells[k], score = list->scores[k];
+        bool won = list->wins[k];
+        list->cells[k] = list->cells[bestIndex];
+        list->scores[k] = list->scores[bestIndex];
+        list->wins[k] = list->wins[bestIndex];
+        list->cells[bestIndex] = cell;
+        list->scores[bestIndex] = score;
+        list->wins[bestIndex] = won;
+    }
+}
+
+static void recordCutoffMove(SearchContext* ctx, int currentPlayer, int cell, int depth) {
+    int ply = __builtin_popcount(ctx->board.stones[1] | ctx->board.stones[2]);
+    if (ctx->killerMoves[ply][0] != cell + 1) {
+        ctx->killerMoves[ply][1] = ctx->killerMoves[ply][0];
+        ctx->killerMoves[ply][0] = cell + 1;
+    }
+    ctx->historyScore[currentPlayer][cell] += depth * depth;
+    if (ctx->historyScore[currentPlayer][cell] > HISTORY_LIMIT) {
+        // Starzenie historii - połowa wartości dla wszystkich pól
+        for (int p = 1; p <= 2; p++) {
+            for (int c = 0; c < BB_CELLS; c++) {
+                ctx->historyScore[p][c] /= 2;
+            }
+        }
+    }
+}
+
+// === PRZESZUKIWANIE ===
+
+// Węzeł minimax dla pozycji, o której wiadomo że nie jest końcowa.
+// Wygrana/przegrana po ruchu może powstać tylko na liniach przez postawiony kamień,
+// więc każdy ruch jest sprawdzany lokalnie (bbWouldWin/bbWouldLose), a wynik końcowy
+// jest zwracany bez schodzenia do potomka.
+static int minimaxNode(SearchContext* ctx, int depth, int alpha, int beta, int currentPlayer, bool maximizing,
+                       int player) {
+    // Limit czasu i flaga zatrzymania sprawdzane co 1024 węzły
+    if ((++ctx->stats.nodes & 1023) == 0) searchPollStop(ctx);
+    if (ctx->aborted) return 0;
+
+    BitBoard* bb = &ctx->board;
+
+    // Tablica końcówek: dokładna wartość pozycji bez dalszego przeszukiwania
+    int tbValue;
+    if (tbProbe(ctx->tablebase, bb, currentPlayer, &tbValue)) {
+        return (currentPlayer == player ? tbValue : -tbValue) * 10000;
+    }
+
+    // Sprawdź głębokość
+    if (depth == 0) {
+        return evaluateBitboard(bb, player);
+    }
+
+    // Tablica transpozycji: wynik z co najmniej tej samej głębokości zawęża okno lub kończy węzeł
+    // Klucz jest kanoniczny - symetryczne poddrzewa trafiają w ten sam wpis
+    TranspositionTable* tt = ctx->tt;
+    int alphaOrig = alpha, betaOrig = beta;
+    uint64_t key = 0;
+    int orientation = 0;
+    int ttCell = -1;
+    if (tt) {
+        TTData entry;
+        key = ttNodeKey(bb, currentPlayer, maximizing, player, &orientation);
+        ctx->stats.ttProbes++;
+        bool found = ttProbe(tt, key, &entry);
+        if (found) ctx->stats.ttHits++;
+        if (found && entry.bestCell >= 0) {
+            ttCell = bbSymInverse[orientation][entry.bestCell];
+        }
+        if (found && entry.depth >= depth) {
+            if (entry.bound == TT_EXACT) {
+                ctx->stats.ttCutoffs++;
+                return entry.score;
+            }
+            if (entry.bound == TT_LOWER && entry.score > alpha) alpha = entry.score;
+            if (entry.bound == TT_UPPER && entry.score < beta) beta = entry.score;
+            if (beta <= alpha) {
+                ctx->stats.ttCutoffs++;
+                return entry.score;
+            }
+        }
+    }
+
+    // Wartość ruchu wygrywającego dla aktualnego gracza (z perspektywy 'player')
+    int winValue = (currentPlayer == player) ? 10000 : -10000;
+
+    MoveList moves;
+    orderMoves(ctx, currentPlayer, ttCell, &moves);
+
+    int best = maximizing ? -100000 : 100000;
+    int bestCell = -1;
+    bool hasLegalMove = (moves.count > 0);
+    for (int k = 0; k < moves.count; k++) {
+        pickNextMove(&moves, k);
+        int cell = moves.cells[k];
+        bool won = moves.wins[k];
+
+        int val = winValue;
+        if (!won) {
+            bbPlace(bb, cell, currentPlayer);
+            val = minimaxNode(ctx, depth - 1, alpha, beta, 3 - currentPlayer, !maximizing, player);
+            bbRemove(bb, cell, currentPlayer);
+            if (ctx->aborted) return 0;  // Wynik przerwanej iteracji jest odrzucany
+        }
+
+        if (maximizing) {
+            if (val > best) {
+                best = val;
+                bestCell = cell;
+            }
+            if (best > alpha) alpha = best;
+        } else {
+            if (val < best) {
+                best = val;
+                bestCell = cell;
+            }
+            if (best < beta) beta = best;
+        }
+        if (beta <= alpha) {
+            // Przycinanie alfa-beta - ruch, który je spowodował, trafia do killerów i historii
+            if (!won) recordCutoffMove(ctx, currentPlayer, cell, depth);
+            break;
+        }
+    }
+
+    // Pełna plansza to remis; jeśli zostały tylko ruchy samobójcze, to przegrana gracza na ruchu
+    if (!hasLegalMove) {
+        best = !bbEmpty(bb) ? 0 : (maximizing ? -10000 : 10000);
+    }
+
+    if (tt) {
+        TTBound bound = TT_EXACT;
+        if (best <= alphaOrig) bound = TT_UPPER;
+        else if (best >= betaOrig) bound = TT_LOWER;
+        if (!hasLegalMove) bound = TT_EXACT;
+        int canonicalCell = (bestCell >= 0) ? bbSymCell[orientation][bestCell] : -1;
+        if (ttStore(tt, key, depth, bound, canonicalCell, best)) ctx->stats.ttStores++;
+    }
+    return best;
+}
+
+// Algorytm minimax z przycinaniem alfa-beta - wspólny silnik gry, uczenia i analizy
+int searchMinimax(SearchContext* ctx, int depth, int alpha, int beta, int currentPlayer, bool maximizing,
+                  int player) {
+    // Pełne sprawdzenie stanów końcowych tylko w korzeniu - dalej wystarczą linie przez ostatni ruch
+    const BitBoard* bb = &ctx->board;
+    if (bbWinCheck(bb, player)) return 10000;        // Wygrana gracza
+    if (bbWinCheck(bb, 3 - player)) return -10000;   // Wygrana przeciwnika
+    if (bbLoseCheck(bb, player)) return -10000;      // Przegrana gracza (3 w rzędzie)
+    if (bbLoseCheck(bb, 3 - player)) return 10000;   // Przegrana przeciwnika (3 w rzędzie)
+
+    return minimaxNode(ctx, depth, alpha, beta, currentPlayer, maximizing, player);
+}
+
+// === WYBÓR RUCHU ===
+
+// Iteracyjne pogłębianie dla jednego wątku: głębokość 1, 2, 3... aż do maxDepth lub końca czasu.
+// Wynik przerwanej iteracji jest odrzucany - zwracany jest ruch z ostatniej pełnej iteracji.
+// Wątki pomocnicze (threadId > 0) zaczynają od innej głębokości i innej kolejności ruchów,
+// żeby wypełniać wspólną tablicę transpozycji innymi poddrzewami niż wątek główny.
+static int iterativeDeepening(SearchContext* ctx, int player, const int* cells, int count, int threadId,
+                              const SearchLimits* limits, int* outScore, int* outDepth) {
+    int rootCells[BB_CELLS];
+    for (int k = 0; k < count; k++) {
+        rootCells[k] = cells[(k + threadId) % count];
+    }
+
+    BitBoard* bb = &ctx->board;
+    bool verbose = limits->verbose && threadId == 0;
+    int bestCell = -1;
+    *outScore = -100000;
+    *outDepth = 0;
+    searchStartTimer(ctx, limits->timeLimitMs);
+    if (limits->keepHistory) searchAgeHistory(ctx);
+    else searchClearHistory(ctx);
+    for (int depth = 1 + (threadId & 1); depth <= limits->maxDepth && count > 0; depth++) {
+        int iterScore = -100000;
+        int iterIndex = -1;
+        for (int k = 0; k < count; k++) {
+            bbPlace(bb, rootCells[k], player);
+            int score = searchMinimax(ctx, depth - 1, iterScore, 100000, 3 - player, false, player);
+            bbRemove(bb, rootCells[k], player);
+            if (searchTimedOut(ctx)) break;
+            if (score > iterScore) {
+                iterScore = score;
+                iterIndex = k;
+            }
+        }
+        if (searchTimedOut(ctx)) {
+            if (verbose) {
+                printf("[ID] depth=%d aborted after %.0f ms\n", depth, searchElapsedMs(ctx));
+            }
+            break;
+        }
+
+        bestCell = rootCells[iterIndex];
+        *outScore = iterScore;
+        *outDepth = depth;
+        if (verbose) {
+            printf("[ID] depth=%d move=%d score=%d nodes=%lld time=%.0f ms\n",
+                   depth, bbCellToMove(bestCell), iterScore, ctx->stats.nodes, searchElapsedMs(ctx));
+        }
+
+        // Wariant główny: najlepszy ruch tej iteracji jest sprawdzany jako pierwszy w następnej
+        for (int k = iterIndex; k > 0; k--) rootCells[k] = rootCells[k - 1];
+        rootCells[0] = bestCell;
+
+        // Wynik rozstrzygnięty - głębsze przeszukiwanie go nie zmieni
+        if (iterScore >= 10000 || iterScore <= -10000) break;
+        // Następna iteracja nie zmieści się w pozostałym czasie
+        if (limits->timeLimitMs > 0 && searchElapsedMs(ctx) > limits->timeLimitMs / 2.0) break;
+    }
+    return bestCell;
+}
+
+SearchResult searchBestMove(SearchContext* ctx, int player, const SearchLimits* limits) {
+    SearchResult result = { 0, -100000, 0, 0 };
+    BitBoard* bb = &ctx->board;
+    int safeCell = -1;
+
+    // Natychmiastowa wygrana ma pierwszeństwo przed blokadą na dowolnym polu
+    uint32_t empty = bbEmpty(bb);
+    for (uint32_t e = empty; e; e &= e - 1) {
+        if (bbWouldWin(bb, player, __builtin_ctz(e))) {
+            result.move = bbCellToMove(__builtin_ctz(e));
+            result.score = 10000;
+            return result;
+        }
+    }
+
+    // Ruchy w korzeniu: blokada kończy wybór, samobójcze są odrzucane
+    int rootCells[BB_CELLS];
+    int rootCount = 0;
+    while (empty) {
+        int cell = __builtin_ctz(empty);
+        empty &= empty - 1;
+        // Jeśli ten ruch blokuje natychmiastową wygraną przeciwnika, wybierz go
+        if (bbWouldWin(bb, 3 - player, cell)) {
+            result.move = bbCellToMove(cell);
+            result.score = 0;
+            return result;
+        }
+        // Odrzuć ruch, jeśli natychmiast przegrywasz (3 w rzędzie)
+        if (bbWouldLose(bb, player, cell)) {
+            continue; // Całkowicie odrzuć ten ruch - nie jest bezpieczny
+        }
+        // Ten ruch jest bezpieczny (nie powoduje natychmiastowej przegranej)
+        if (safeCell < 0) safeCell = cell;
+        rootCells[rootCount++] = cell;
+    }
+
+    // Końcówka: dokładne rozwiązanie każdego ruchu. Wygrana kończy wybór, przy remisie lub
+    // przegranej heurystyka wybiera spośród ruchów o najlepszej wartości (szansa na błąd przeciwnika).
+    SearchLimits searchLimits = *limits;
+    int emptyCount = __builtin_popcount(bbEmpty(bb));
+    if (rootCount > 0 && emptyCount <= limits->solveEmpty) {
+        int values[BB_CELLS];
+        int bestValue = EG_LOSS;
+        int solved = 0;
+        // Solver dostaje połowę limitu (jak jedna iteracja w iterativeDeepening), żeby przy pozycji
+        // zbyt trudnej do rozwiązania zostało realne okno na przeszukiwanie heurystyczne
+        int solveMs = (limits->timeLimitMs > 1) ? limits->timeLimitMs / 2 : limits->timeLimitMs;
+        searchStartTimer(ctx, solveMs);
+        while (solved < rootCount && bestValue != EG_WIN && !searchTimedOut(ctx)) {
+            bbPlace(bb, rootCells[solved], player);
+            values[solved] = -egSolve(ctx, 3 - player);
+            bbRemove(bb, rootCells[solved], player);
+            if (values[solved] > bestValue) bestValue = values[solved];
+            solved++;
+        }
+        if (searchTimedOut(ctx)) {
+            if (limits->verbose) {
+                printf("[SOLVE] empty=%d aborted after %.0f ms, using heuristic search\n",
+                       emptyCount, searchElapsedMs(ctx));
+            }
+        } else {
+            int kept = 0;
+            for (int k = 0; k < solved; k++) {
+                if (values[k] == bestValue) rootCells[kept++] = rootCells[k];
+            }
+            rootCount = kept;
+            if (limits->verbose) {
+                printf("[SOLVE] empty=%d value=%s moves=%d nodes=%lld time=%.0f ms\n", emptyCount,
+                       bestValue == EG_WIN ? "win" : bestValue == EG_DRAW ? "draw" : "loss",
+                       rootCount, ctx->stats.nodes, searchElapsedMs(ctx));
+            }
+            if (bestValue == EG_WIN || rootCount == 1) {
+                result.move = bbCellToMove(rootCells[0]);
+                result.score = bestValue * 10000;
+                result.nodes = ctx->stats.nodes;
+                return result;
+            }
+        }
+        // Wspólny limit ruchu: przeszukiwanie heurystyczne (po przerwaniu solvera albo przy kilku
+        // ruchach o najlepszej wartości) dostaje tylko czas pozostały po rozwiązywaniu
+        if (limits->timeLimitMs > 0) {
+            int remainingMs = limits->timeLimitMs - (int)searchElapsedMs(ctx);
+            searchLimits.timeLimitMs = (remainingMs > 1) ? remainingMs : 1;
+        }
+    }
+
+    // Ruch z tablicy transpozycji dla korzenia idzie pierwszy - przy tablicy zachowanej między ruchami
+    // to wariant główny z poprzedniego przeszukiwania (poddrzewo pod faktyczną odpowiedzią przeciwnika)
+    if (ctx->tt && rootCount > 1) {
+        TTData entry;
+        int orientation;
+        uint64_t key = ttNodeKey(bb, player, true, player, &orientation);
+        if (ttProbe(ctx->tt, key, &entry) && entry.bestCell >= 0) {
+            int ttCell = bbSymInverse[orientation][entry.bestCell];
+            for (int k = 1; k < rootCount; k++) {
+                if (rootCells[k] != ttCell) continue;
+                for (; k > 0; k--) rootCells[k] = rootCells[k - 1];
+                rootCells[0] = ttCell;
+                if (limits->verbose) printf("[ID] root move %d from transposition table\n", bbCellToMove(ttCell));
+                break;
+            }
+        }
+    }
+
+    // Iteracyjne pogłębianie (Lazy SMP gdy threads > 1). Wynik podaje wątek główny (ctx),
+    // pomocnicy mają własne konteksty z tą samą tablicą transpozycji.
+    atomic_bool helpersStop = false;
+    long long threadNodes[MAX_SEARCH_THREADS] = {0};
+    double threadMs[MAX_SEARCH_THREADS] = {0};
+    int threads = (rootCount > 1) ? searchLimits.threads : 1;
+    if (threads < 1) threads = 1;
+    if (threads > MAX_SEARCH_THREADS) threads = MAX_SEARCH_THREADS;
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(threads)
+#endif
+    {
+        int threadId = 0;
+#ifdef _OPENMP
+        threadId = omp_get_thread_num();
+#endif
+        SearchContext helper;
+        SearchContext* local = ctx;
+        if (threadId > 0) {
+            searchInit(&helper, ctx->tt);
+            searchSetPosition(&helper, &ctx->board);
+            helper.stop = &helpersStop;
+            helper.tablebase = ctx->tablebase;
+            local = &helper;
+        }
+        int score = -100000, depth = 0;
+        int cell = iterativeDeepening(local, player, rootCells, rootCount, threadId, &searchLimits, &score, &depth);
+        if (threadId == 0) {
+            // Wątek główny skończył - pomocnicy przerywają bieżącą iterację
+            atomic_store_explicit(&helpersStop, true, memory_order_relaxed);
+            if (cell >= 0) {
+                result.move = bbCellToMove(cell);
+                result.score = score;
+            }
+            result.depth = depth;
+        }
+        threadNodes[threadId] = local->stats.nodes;
+        threadMs[threadId] = searchElapsedMs(local);
+        searchFlushStats(local);
+    }
+
+    for (int t = 0; t < threads; t++) {
+        result.nodes += threadNodes[t];
+    }
+    if (limits->verbose) {
+        printf("[ID] completed depth %d/%d, score %d\n", result.depth, limits->maxDepth, result.score);
+        if (threads > 1) {
+            for (int t = 0; t < threads; t++) {
+                double nps = threadMs[t] > 0 ? threadNodes[t] * 1000.0 / threadMs[t] : 0.0;
+                printf("[SMP] thread %d: nodes=%lld time=%.0f ms nps=%.0f\n", t, threadNodes[t], threadMs[t], nps);
+            }
+            printf("[SMP] total nodes=%lld with %d threads\n", result.nodes, threads);
+        }
+    }
+
+    // Jeśli przeszukiwanie nie dało ruchu, wybierz pierwszy bezpieczny
+    if (result.move == 0 && safeCell >= 0) {
+        result.move = bbCellToMove(safeCell);
+    }
+    // Jeśli nie ma bezpiecznego ruchu, wybierz wolne pole najbliżej środka planszy
+    if (result.move == 0) {
+        int bestDist = 100;
+        empty = bbEmpty(bb);
+        while (empty) {
+            int cell = __builtin_ctz(empty);
+            empty &= empty - 1;
+            int dist = (cell / 5 - 2) * (cell / 5 - 2) + (cell % 5 - 2) * (cell % 5 - 2);
+            if (dist < bestDist) {
+                bestDist = dist;
+                result.move = bbCellToMove(cell);
+            }
+        }
+    }
+    return result;
+}
+
+// === PONDERING ===
+
+#define PONDER_ORDER_DEPTH 3
+
+// Odpowiedzi przeciwnika są porządkowane płytkim przeszukiwaniem z jego perspektywy, potem dla
+// każdej liczony jest nasz ruch bez limitu czasu (tylko limit głębokości i flaga zatrzymania).
+// Przerwana odpowiedź nie trafia do wyniku, ale jej wpisy zostają we wspólnej tablicy transpozycji.
+void searchPonder(SearchContext* ctx, int player, const SearchLimits* limits, PonderResult* out) {
+    memset(out, 0, sizeof(*out));
+    BitBoard* bb = &ctx->board;
+    int opponent = 3 - player;
+
+    MoveList replies;
+    replies.count = 0;
+    searchStartTimer(ctx, 0);
+    for (uint32_t empty = bbEmpty(bb); empty; empty &= empty - 1) {
+        int cell = __builtin_ctz(empty);
+        // Ruch kończący grę nie wymaga odpowiedzi
+        if (bbWouldWin(bb, opponent, cell) || bbWouldLose(bb, opponent, cell)) continue;
+        bbPlace(bb, cell, opponent);
+        int score = searchMinimax(ctx, PONDER_ORDER_DEPTH, -100000, 100000, player, false, opponent);
+        bbRemove(bb, cell, opponent);
+        if (searchTimedOut(ctx)) return;
+        replies.cells[replies.count] = cell;
+        replies.scores[replies.count] = score;
+        replies.wins[replies.count] = false;
+        replies.count++;
+    }
+    out->replies = replies.count;
+    out->nodes = ctx->stats.nodes;
+
+    SearchLimits ponderLimits = *limits;
+    ponderLimits.timeLimitMs = 0;
+    ponderLimits.verbose = false;
+    for (int k = 0; k < replies.count; k++) {
+        pickNextMove(&replies, k);
+        int cell = replies.cells[k];
+        bbPlace(bb, cell, opponent);
+        ctx->aborted = false;  // Natychmiastowa wygrana/blokada nie uruchamia pomiaru czasu
+        SearchResult result = searchBestMove(ctx, player, &ponderLimits);
+        bbRemove(bb, cell, opponent);
+        out->nodes += result.nodes;
+        if (searchTimedOut(ctx)) break;
+        out->move[cell] = result.move;
+        out->score[cell] = result.score;
+        out->depth[cell] = result.depth;
+        out->searched++;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "bitboard.h"
+#include "endgame.h"
+#include "tablebase.h"
+#include "transposition.h"
+
+#define SEARCH_MAX_PLY (BB_CELLS + 1)
+#define MAX_SEARCH_THREADS 64
+
+// Statystyki jednego kontekstu przeszukiwania
+typedef struct {
+    long long nodes;
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t ttCutoffs;
+    uint64_t ttStores;
+} SearchStats;
+
+// Kontekst przeszukiwania - cały stan jednego wyszukiwania w jednej strukturze.
+// Nie ma stanu globalnego, więc dowolnie wiele kontekstów może działać równolegle
+// (gra, wątki Lazy SMP, wątki uczenia książki, analiza).
+typedef struct SearchContext {
+    BitBoard board;                             // Przeszukiwana pozycja
+    TranspositionTable* tt;                     // NULL = bez tablicy; może być współdzielona
+    EndgameCache* endgame;                      // Pamięć solvera końcówek (NULL = bez pamięci)
+    const Tablebase* tablebase;                 // Tablica końcówek z pliku (NULL = brak)
+    atomic_bool* stop;                          // Wspólna flaga zatrzymania (NULL = brak)
+    int killerMoves[SEARCH_MAX_PLY][2];         // Pole + 1 (0 = brak), indeks = liczba kamieni
+    int historyScore[3][BB_CELLS];
+    SearchStats stats;
+    double startTime;
+    double deadline;                            // 0 = brak limitu czasu
+    bool aborted;
+} SearchContext;
+
+// Ograniczenia wyboru ruchu
+typedef struct {
+    int maxDepth;
+    int timeLimitMs;    // 0 = tylko limit głębokości
+    int threads;        // > 1 = Lazy SMP
+    int solveEmpty;     // Dokładny solver końcówek od tylu pustych pól (0 = wyłączony)
+    bool verbose;       // Wypisywanie postępu [ID] / [SMP] / [TT]
+    bool keepHistory;   // Kontekst całej gry: killery i historia z poprzednich ruchów zostają (postarzone)
+} SearchLimits;
+
+// Wynik wyboru ruchu
+typedef struct {
+    int move;           // Ruch w formacie wiersz*10 + kolumna (0 = brak)
+    int score;
+    int depth;          // Głębokość ostatniej pełnej iteracji
+    long long nodes;    // Suma węzłów ze wszystkich wątków
+} SearchResult;
+
+// Wynik pondering: nasza odpowiedź na każdy przeszukany ruch przeciwnika (indeks = pole przeciwnika)
+typedef struct {
+    int move[BB_CELLS];     // 0 = odpowiedź nie została przeszukana do końca
+    int score[BB_CELLS];
+    int depth[BB_CELLS];
+    int replies;            // Liczba ruchów przeciwnika do przeszukania
+    int searched;           // Liczba zakończonych odpowiedzi
+    long long nodes;
+} PonderResult;
+
+// === KONTEKST ===
+void searchInit(SearchContext* ctx, TranspositionTable* tt);
+void searchSetPosition(SearchContext* ctx, const BitBoard* bb);
+void searchClearHistory(SearchContext* ctx);
+void searchAgeHistory(SearchContext* ctx);  // Połowa wartości historii, killery bez zmian
+void searchStartTimer(SearchContext* ctx, int timeLimitMs);
+bool searchTimedOut(const SearchContext* ctx);
+double searchElapsedMs(const SearchContext* ctx);
+void searchPollStop(SearchContext* ctx);    // Sprawdza limit czasu i flagę zatrzymania (ustawia ctx->aborted)
+void searchFlushStats(SearchContext* ctx);  // Dodaje liczniki TT kontekstu do sum w tablicy
+
+// === PRZESZUKIWANIE ===
+
+// Minimax z przycinaniem alfa-beta na ctx->board (wartość z perspektywy 'player')
+int searchMinimax(SearchContext* ctx, int depth, int alpha, int beta, int currentPlayer, bool maximizing,
+                  int player);
+
+// Wybór ruchu dla 'player' w pozycji ctx->board: natychmiastowa wygrana/blokada,
+// iteracyjne pogłębianie z limitem czasu, Lazy SMP dla limits->threads > 1
+SearchResult searchBestMove(SearchContext* ctx, int player, const SearchLimits* limits);
+
+// Pondering w czasie przeciwnika: ctx->board to pozycja po naszym ruchu. Dla kolejnych odpowiedzi
+// przeciwnika (najgroźniejsze najpierw) liczy nasz ruch jak searchBestMove, aż do ustawienia ctx->stop
+void searchPonder(SearchContext* ctx, int player, const SearchLimits* limits, PonderResult* out);
+
+#endif // SEARCH_H
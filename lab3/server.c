@@ -0,0 +1,424 @@
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+// Lokalny serwer gry: ten sam protokół co serwer zewnętrzny (powitanie, "<id> <nazwa>",
+// wiadomości msg*100+ruch), sędziowanie regułami z board.h i wiele równoczesnych meczów
+// w jednej pętli epoll. Dla każdego ruchu mierzy czas od wysłania wiadomości do odpowiedzi bota.
+
+#define SERVER_MAX_EVENTS 256
+#define SERVER_MAX_NAMES 32
+#define SERVER_MESSAGE_SIZE 16
+
+// Kody wiadomości (msg w msg*100+ruch), tak jak w main() bota
+#define MSG_MOVE 0
+#define MSG_WIN 1
+#define MSG_LOSE 2
+#define MSG_DRAW 3
+#define MSG_OPPONENT_ERROR 4
+#define MSG_YOUR_ERROR 5
+#define MSG_START 6
+#define MSG_GREETING 700
+
+struct Match;
+
+// Połączenie jednego bota
+typedef struct Connection {
+    int fd;
+    int player;                 // 1 lub 2 z wiadomości "<id> <nazwa>" (0 = przed przedstawieniem się)
+    char name[SERVER_MESSAGE_SIZE];
+    struct Match* match;
+    struct Connection* nextWaiting;  // Kolejka botów czekających na przeciwnika
+} Connection;
+
+// Mecz dwóch botów; plansza kopiowana do globalnej planszy board.h na czas sędziowania
+typedef struct Match {
+    Connection* players[3];     // Indeks = numer gracza
+    int cells[5][5];
+    int toMove;
+    int moves;
+    double sentAt;              // Wysłanie wiadomości graczowi na ruchu (ms)
+} Match;
+
+// Czasy odpowiedzi botów o jednej nazwie
+typedef struct {
+    char name[SERVER_MESSAGE_SIZE];
+    double* values;
+    long long count;
+    long long capacity;
+} LatencySeries;
+
+int epollFd = -1;
+Connection* waitingHead[3];     // Kolejki FIFO czekających graczy 1 i 2
+Connection* waitingTail[3];
+Connection* closedConnections;  // Do zwolnienia po bieżącej porcji zdarzeń
+Match** activeMatches;          // Trwające mecze (sprawdzanie limitu czasu)
+int activeCount = 0, activeCapacity = 0;
+LatencySeries latencySeries[SERVER_MAX_NAMES + 1];  // Ostatni wpis = suma wszystkich botów
+int seriesCount = 0;
+int gamesLimit = 0;             // 0 = bez limitu (do Ctrl+C)
+int moveTimeoutMs = 0;          // 0 = bez limitu czasu na ruch
+int gamesFinished = 0;
+int gameResults[4];             // Wygrane gracza 1, gracza 2, remisy, gry zakończone błędem
+volatile sig_atomic_t stopRequested = 0;
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec * 1e-6;
+}
+
+static void handleSignal(int sig) {
+    (void)sig;
+    stopRequested = 1;
+}
+
+// === POMIAR CZASU ODPOWIEDZI ===
+
+static void addLatencyValue(LatencySeries* series, double ms) {
+    if (series->count == series->capacity) {
+        long long capacity = series->capacity ? series->capacity * 2 : 1024;
+        double* grown = realloc(series->values, capacity * sizeof(double));
+        if (!grown) return;  // Brak pamięci - pomiar pominięty, mecz trwa dalej
+        series->values = grown;
+        series->capacity = capacity;
+    }
+    series->values[series->count++] = ms;
+}
+
+static void recordLatency(const char* name, double ms) {
+    LatencySeries* series = NULL;
+    for (int i = 0; i < seriesCount; i++) {
+        if (strcmp(latencySeries[i].name, name) == 0) series = &latencySeries[i];
+    }
+    if (!series && seriesCount < SERVER_MAX_NAMES) {
+        series = &latencySeries[seriesCount++];
+        snprintf(series->name, sizeof(series->name), "%s", name);
+    }
+    if (series) addLatencyValue(series, ms);
+    addLatencyValue(&latencySeries[SERVER_MAX_NAMES], ms);
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void printLatency(LatencySeries* series) {
+    if (series->count == 0) return;
+    qsort(series->values, series->count, sizeof(double), compareDoubles);
+    double sum = 0.0;
+    for (long long i = 0; i < series->count; i++) sum += series->values[i];
+    long long last = series->count - 1;
+    printf("%-15s moves=%lld avg=%.2f ms p50=%.2f p90=%.2f p99=%.2f max=%.2f ms\n", series->name,
+           series->count, sum / series->count, series->values[last * 50 / 100],
+           series->values[last * 90 / 100], series->values[last * 99 / 100], series->values[last]);
+}
+
+static void printReport(void) {
+    printf("\n=== SERVER REPORT ===\n");
+    printf("Games: %d (player 1 wins %d, player 2 wins %d, draws %d, errors %d)\n", gamesFinished,
+           gameResults[0], gameResults[1], gameResults[2], gameResults[3]);
+    printf("Move latency (message sent -> reply received):\n");
+    for (int i = 0; i < seriesCount; i++) printLatency(&latencySeries[i]);
+    snprintf(latencySeries[SERVER_MAX_NAMES].name, SERVER_MESSAGE_SIZE, "all");
+    printLatency(&latencySeries[SERVER_MAX_NAMES]);
+}
+
+// === POŁĄCZENIA ===
+
+static bool sendCode(Connection* conn, int code) {
+    char message[SERVER_MESSAGE_SIZE];
+    int length = snprintf(message, sizeof(message), "%d", code);
+    return send(conn->fd, message, length, MSG_NOSIGNAL) == length;
+}
+
+// Zamknięte połączenie jest zwalniane dopiero po obsłudze całej porcji zdarzeń epoll -
+// w tej samej porcji może czekać jeszcze zdarzenie dla niego
+static void closeConnection(Connection* conn) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->fd = -1;
+    conn->match = NULL;
+    conn->nextWaiting = closedConnections;
+    closedConnections = conn;
+}
+
+static void freeClosedConnections(void) {
+    while (closedConnections) {
+        Connection* next = closedConnections->nextWaiting;
+        free(closedConnections);
+        closedConnections = next;
+    }
+}
+
+static void removeWaiting(Connection* conn) {
+    int p = conn->player;
+    Connection** link = &waitingHead[p];
+    Connection* previous = NULL;
+    while (*link && *link != conn) {
+        previous = *link;
+        link = &(*link)->nextWaiting;
+    }
+    if (!*link) return;
+    *link = conn->nextWaiting;
+    if (waitingTail[p] == conn) waitingTail[p] = previous;
+}
+
+// === MECZE ===
+
+static void finishMatch(Match* match, int resultIndex) {
+    for (int i = 0; i < activeCount; i++) {
+        if (activeMatches[i] == match) {
+            activeMatches[i] = activeMatches[--activeCount];
+            break;
+        }
+    }
+    closeConnection(match->players[1]);
+    closeConnection(match->players[2]);
+    free(match);
+    gameResults[resultIndex]++;
+    gamesFinished++;
+    if (gamesLimit > 0 && gamesFinished >= gamesLimit) stopRequested = 1;
+}
+
+// Błąd gracza 'player' (zły ruch, rozłączenie, przekroczony czas) - przeciwnik wygrywa
+static void forfeitMatch(Match* match, int player) {
+    sendCode(match->players[player], MSG_YOUR_ERROR * 100);
+    sendCode(match->players[3 - player], MSG_OPPONENT_ERROR * 100);
+    finishMatch(match, 3);
+}
+
+static void startMatch(Connection* first, Connection* second) {
+    Match* match = calloc(1, sizeof(Match));
+    if (match && activeCount == activeCapacity) {
+        int capacity = activeCapacity ? activeCapacity * 2 : 64;
+        Match** grown = realloc(activeMatches, capacity * sizeof(Match*));
+        if (grown) {
+            activeMatches = grown;
+            activeCapacity = capacity;
+        }
+    }
+    if (!match || activeCount == activeCapacity) {
+        printf("Error: Cannot allocate match!\n");
+        free(match);
+        closeConnection(first);
+        closeConnection(second);
+        return;
+    }
+    activeMatches[activeCount++] = match;
+    match->players[1] = first;
+    match->players[2] = second;
+    first->match = second->match = match;
+    match->toMove = 1;
+    match->sentAt = nowMs();
+    if (!sendCode(first, MSG_START * 100)) forfeitMatch(match, 1);
+}
+
+// Ruch gracza na ruchu - reguły i wyniki z board.h
+static void playMove(Match* match, int move) {
+    int mover = match->toMove;
+    Connection* current = match->players[mover];
+    Connection* other = match->players[3 - mover];
+    recordLatency(current->name, nowMs() - match->sentAt);
+
+    memcpy(board, match->cells, sizeof(board));
+    if (!setMove(move, mover)) {
+        forfeitMatch(match, mover);
+        return;
+    }
+    memcpy(match->cells, board, sizeof(board));
+    match->moves++;
+
+    // 4 w rzędzie wygrywa przed 3 w rzędzie; ruch dostaje tylko przeciwnik (bot nanosi go na planszę)
+    if (winCheck(mover)) {
+        sendCode(current, MSG_WIN * 100);
+        sendCode(other, MSG_LOSE * 100 + move);
+        finishMatch(match, mover - 1);
+    } else if (loseCheck(mover)) {
+        sendCode(current, MSG_LOSE * 100);
+        sendCode(other, MSG_WIN * 100 + move);
+        finishMatch(match, 2 - mover);
+    } else if (match->moves == 25) {
+        sendCode(current, MSG_DRAW * 100);
+        sendCode(other, MSG_DRAW * 100 + move);
+        finishMatch(match, 2);
+    } else {
+        match->toMove = 3 - mover;
+        match->sentAt = nowMs();
+        if (!sendCode(other, MSG_MOVE * 100 + move)) forfeitMatch(match, 3 - mover);
+    }
+}
+
+// Przedstawienie się bota "<id> <nazwa>" - bot trafia do kolejki, a para 1 + 2 zaczyna mecz
+static void handleHello(Connection* conn, const char* message) {
+    int id = 0;
+    char name[SERVER_MESSAGE_SIZE] = "";
+    if (sscanf(message, "%d %15s", &id, name) < 1 || (id != 1 && id != 2)) {
+        printf("Invalid hello message: '%s'\n", message);
+        closeConnection(conn);
+        return;
+    }
+    conn->player = id;
+    snprintf(conn->name, sizeof(conn->name), "%s", name[0] ? name : "?");
+
+    Connection* opponent = waitingHead[3 - id];
+    if (opponent) {
+        removeWaiting(opponent);
+        if (id == 1) startMatch(conn, opponent);
+        else startMatch(opponent, conn);
+        return;
+    }
+    conn->nextWaiting = NULL;
+    if (waitingTail[id]) waitingTail[id]->nextWaiting = conn;
+    else waitingHead[id] = conn;
+    waitingTail[id] = conn;
+}
+
+static void handleReadable(Connection* conn) {
+    if (conn->fd < 0) return;  // Zamknięte wcześniej w tej samej porcji zdarzeń
+    char message[SERVER_MESSAGE_SIZE];
+    memset(message, '\0', sizeof(message));
+    // Protokół nie ma separatora - jak bot, jedna wiadomość na jeden odczyt
+    ssize_t received = recv(conn->fd, message, sizeof(message) - 1, 0);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+
+    Match* match = conn->match;
+    if (received <= 0) {
+        // Rozłączenie w trakcie meczu to błąd tego gracza
+        if (match) forfeitMatch(match, conn->player);
+        else {
+            if (conn->player) removeWaiting(conn);
+            closeConnection(conn);
+        }
+        return;
+    }
+
+    if (conn->player == 0) {
+        handleHello(conn, message);
+    } else if (!match) {
+        return;  // Wiadomość przed rozpoczęciem meczu - pomijana
+    } else if (conn->player != match->toMove) {
+        forfeitMatch(match, conn->player);  // Ruch poza kolejką
+    } else {
+        int move = 0;
+        if (sscanf(message, "%d", &move) != 1) move = 0;
+        playMove(match, move);
+    }
+}
+
+// Gracze, którzy nie odpowiedzieli w limicie czasu, przegrywają
+static void checkTimeouts(void) {
+    if (moveTimeoutMs <= 0) return;
+    double now = nowMs();
+    for (int i = activeCount - 1; i >= 0; i--) {
+        Match* match = activeMatches[i];
+        if (now - match->sentAt > moveTimeoutMs) {
+            printf("Player %d (%s) exceeded %d ms\n", match->toMove, match->players[match->toMove]->name,
+                   moveTimeoutMs);
+            forfeitMatch(match, match->toMove);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <IP> <PORT> [--games=N] [--timeout-ms=T]\n", argv[0]);
+        return -1;
+    }
+    for (int i = 3; i < argc; i++) {
+        if (strstr(argv[i], "--games=") != NULL) {
+            sscanf(argv[i], "--games=%d", &gamesLimit);
+        }
+        if (strstr(argv[i], "--timeout-ms=") != NULL) {
+            sscanf(argv[i], "--timeout-ms=%d", &moveTimeoutMs);
+        }
+    }
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        printf("Unable to create socket\n");
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(atoi(argv[2]));
+    serverAddr.sin_addr.s_addr = inet_addr(argv[1]);
+    if (bind(listenFd, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        printf("Unable to bind %s:%s\n", argv[1], argv[2]);
+        return -1;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        printf("Unable to create epoll instance\n");
+        return -1;
+    }
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };  // NULL = gniazdo nasłuchujące
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSignal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    printf("Server listening on %s:%s", argv[1], argv[2]);
+    if (gamesLimit > 0) printf(" (%d games)", gamesLimit);
+    if (moveTimeoutMs > 0) printf(" (timeout %d ms per move)", moveTimeoutMs);
+    printf("\n");
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!stopRequested) {
+        // Z limitem czasu na ruch pętla budzi się co najmniej co 10 ms
+        int ready = epoll_wait(epollFd, events, SERVER_MAX_EVENTS, moveTimeoutMs > 0 ? 10 : -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            printf("Error in epoll_wait\n");
+            break;
+        }
+        for (int i = 0; i < ready && !stopRequested; i++) {
+            if (events[i].data.ptr == NULL) {
+                // Nowe połączenia: powitanie od razu, przedstawienie się przyjdzie jako zdarzenie
+                int fd;
+                while ((fd = accept(listenFd, NULL, NULL)) >= 0) {
+                    Connection* conn = calloc(1, sizeof(Connection));
+                    if (!conn) {
+                        close(fd);
+                        continue;
+                    }
+                    conn->fd = fd;
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    struct epoll_event connEvent = { .events = EPOLLIN, .data.ptr = conn };
+                    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &connEvent) < 0 || !sendCode(conn, MSG_GREETING)) {
+                        close(fd);
+                        free(conn);
+                    }
+                }
+            } else {
+                handleReadable(events[i].data.ptr);
+            }
+        }
+        checkTimeouts();
+        freeClosedConnections();
+    }
+
+    printReport();
+    close(epollFd);
+    close(listenFd);
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "tablebase.h"
+#include "endgame.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// === GENEROWANIE ===
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Rosnąca tablica kodów jednej warstwy
+typedef struct {
+    uint64_t* codes;
+    uint64_t count;
+    uint64_t capacity;
+} CodeList;
+
+static bool pushCode(CodeList* list, uint64_t code) {
+    if (list->count == list->capacity) {
+        uint64_t capacity = list->capacity ? list->capacity * 2 : 1024;
+        uint64_t* grown = realloc(list->codes, capacity * sizeof(uint64_t));
+        if (!grown) return false;
+        list->codes = grown;
+        list->capacity = capacity;
+    }
+    list->codes[list->count++] = code;
+    return true;
+}
+
+static int compareCodes(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Stan wyliczania pozycji jednej warstwy
+typedef struct {
+    int empty;                  // Docelowa liczba pustych pól
+    int moverCount, otherCount; // Docelowa liczba kamieni gracza na ruchu i przeciwnika
+    uint32_t mover, other;
+    CodeList* out;
+    bool ok;
+} Enumeration;
+
+static bool formsThree(uint32_t stones, int cell) {
+    for (int i = 0; i < cellLoseCount[cell]; i++) {
+        if ((stones & cellLoseMasks[cell][i]) == cellLoseMasks[cell][i]) return true;
+    }
+    return false;
+}
+
+// Przypisuje polom po kolei: puste / gracz na ruchu / przeciwnik. Gałęzie z 3 w rzędzie są
+// odcinane (4 w rzędzie zawiera 3 w rzędzie), więc każdy liść jest pozycją nieskończoną -
+// a taka pozycja jest osiągalna w dowolnej kolejności ruchów. Zapisywany jest tylko
+// reprezentant kanoniczny, więc symetryczne pozycje nie powtarzają się.
+static void enumerateCells(Enumeration* en, int cell, int movers, int others, int empties) {
+    if (!en->ok) return;
+    if (cell == BB_CELLS) {
+        BitBoard bb;
+        bb.stones[1] = en->mover;
+        bb.stones[2] = en->other;
+        uint64_t code = bbPositionCode(en->mover, en->other);
+        if (bbCanonicalCode(&bb, 1) == code && !pushCode(en->out, code)) en->ok = false;
+        return;
+    }
+    if (empties < en->empty) {
+        enumerateCells(en, cell + 1, movers, others, empties + 1);
+    }
+    if (movers < en->moverCount) {
+        en->mover |= 1u << cell;
+        if (!formsThree(en->mover, cell)) enumerateCells(en, cell + 1, movers + 1, others, empties);
+        en->mover &= ~(1u << cell);
+    }
+    if (others < en->otherCount) {
+        en->other |= 1u << cell;
+        if (!formsThree(en->other, cell)) enumerateCells(en, cell + 1, movers, others + 1, empties);
+        en->other &= ~(1u << cell);
+    }
+}
+
+static int lookupLayer(const uint64_t* entries, uint64_t count, uint64_t code) {
+    uint64_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi) / 2;
+        uint64_t midCode = entries[mid] >> 2;
+        if (midCode == code) return (int)(entries[mid] & 0x3) - 1;
+        if (midCode < code) lo = mid + 1;
+        else hi = mid;
+    }
+    return -2;  // Brak wpisu
+}
+
+// Wartość pozycji z warstwy k na podstawie gotowej warstwy k - 1 (analiza wsteczna)
+static int solveFromLayer(uint64_t code, const uint64_t* prev, uint64_t prevCount) {
+    BitBoard bb;
+    bb.stones[1] = (uint32_t)(code & BB_FULL);        // Gracz na ruchu
+    bb.stones[2] = (uint32_t)(code >> BB_CELLS);      // Przeciwnik
+    uint32_t empty = bbEmpty(&bb);
+    if (!empty) return EG_DRAW;  // Pełna plansza bez rozstrzygnięcia
+
+    int best = EG_LOSS;
+    for (; empty; empty &= empty - 1) {
+        int cell = __builtin_ctz(empty);
+        if (bbWouldWin(&bb, 1, cell)) return EG_WIN;
+        if (bbWouldLose(&bb, 1, cell)) continue;
+        // Po ruchu role się zamieniają: przeciwnik jest graczem na ruchu
+        BitBoard child;
+        child.stones[1] = bb.stones[2];
+        child.stones[2] = bb.stones[1] | (1u << cell);
+        int childValue = lookupLayer(prev, prevCount, bbCanonicalCode(&child, 1));
+        if (childValue < EG_LOSS) continue;  // Niemożliwe dla poprawnej warstwy k - 1
+        if (-childValue > best) best = -childValue;
+        if (best == EG_WIN) break;
+    }
+    return best;
+}
+
+bool tbGenerate(int maxEmpty, const char* filename) {
+    if (maxEmpty < 0) maxEmpty = 0;
+    if (maxEmpty > TB_MAX_EMPTY) maxEmpty = TB_MAX_EMPTY;
+    printf("=== ENDGAME TABLEBASE GENERATION ===\n");
+    printf("Positions with <= %d empty fields -> %s\n", maxEmpty, filename);
+
+    CodeList layers[TB_MAX_EMPTY + 1];
+    memset(layers, 0, sizeof(layers));
+    bool ok = true;
+    uint64_t total = 0;
+
+    for (int k = 0; k <= maxEmpty && ok; k++) {
+        double start = nowSeconds();
+        // Gracz na ruchu ma nie więcej kamieni niż przeciwnik
+        int stones = BB_CELLS - k;
+        Enumeration en = { k, stones / 2, stones - stones / 2, 0, 0, &layers[k], true };
+        enumerateCells(&en, 0, 0, 0, 0);
+        if (!en.ok) {
+            printf("Error: Cannot allocate memory for tablebase layer %d!\n", k);
+            ok = false;
+            break;
+        }
+        qsort(layers[k].codes, layers[k].count, sizeof(uint64_t), compareCodes);
+
+        // Wartości warstwy k zależą tylko od warstwy k - 1 - wpisy liczone równolegle
+        const uint64_t* prev = (k > 0) ? layers[k - 1].codes : NULL;
+        uint64_t prevCount = (k > 0) ? layers[k - 1].count : 0;
+        uint64_t* codes = layers[k].codes;
+        long long count = (long long)layers[k].count;
+        long long wins = 0, draws = 0, losses = 0;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) reduction(+:wins, draws, losses)
+#endif
+        for (long long i = 0; i < count; i++) {
+            int value = solveFromLayer(codes[i], prev, prevCount);
+            codes[i] = (codes[i] << 2) | (uint64_t)(value + 1);
+            if (value == EG_WIN) wins++;
+            else if (value == EG_DRAW) draws++;
+            else losses++;
+        }
+        total += layers[k].count;
+        printf("[TB] empty=%d positions=%lld win=%lld draw=%lld loss=%lld (%.1f s)\n",
+               k, count, wins, draws, losses, nowSeconds() - start);
+    }
+
+    if (ok) {
+        FILE* file = fopen(filename, "wb");
+        if (!file) {
+            printf("Error: Cannot create tablebase file %s\n", filename);
+            ok = false;
+        } else {
+            TablebaseHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, TB_MAGIC, sizeof(TB_MAGIC));
+            header.maxEmpty = maxEmpty;
+            for (int k = 0; k <= maxEmpty; k++) header.counts[k] = layers[k].count;
+            ok = fwrite(&header, sizeof(header), 1, file) == 1;
+            for (int k = 0; k <= maxEmpty && ok; k++) {
+                ok = fwrite(layers[k].codes, sizeof(uint64_t), layers[k].count, file) == layers[k].count;
+            }
+            if (fclose(file) != 0) ok = false;
+            if (!ok) printf("Error: Cannot write tablebase file %s\n", filename);
+        }
+    }
+    if (ok) {
+        printf("Tablebase saved: %llu positions, %.1f MB\n", (unsigned long long)total,
+               (sizeof(TablebaseHeader) + total * sizeof(uint64_t)) / (1024.0 * 1024.0));
+    }
+
+    for (int k = 0; k <= TB_MAX_EMPTY; k++) free(layers[k].codes);
+    return ok;
+}
+
+// === ODCZYT ===
+
+bool tbOpen(Tablebase* tb, const char* filename) {
+    memset(tb, 0, sizeof(*tb));
+    tb->maxEmpty = -1;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Tablebase file %s not found - endgames without tablebase\n", filename);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TablebaseHeader)) {
+        printf("Error: Invalid tablebase file %s\n", filename);
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // Mapowanie zostaje ważne po zamknięciu deskryptora
+    if (map == MAP_FAILED) {
+        printf("Error: Cannot mmap tablebase file %s\n", filename);
+        return false;
+    }
+
+    const TablebaseHeader* header = map;
+    uint64_t total = 0;
+    bool valid = memcmp(header->magic, TB_MAGIC, sizeof(TB_MAGIC)) == 0 && header->maxEmpty <= TB_MAX_EMPTY;
+    for (int k = 0; valid && k <= (int)header->maxEmpty; k++) total += header->counts[k];
+    if (!valid || sizeof(TablebaseHeader) + total * sizeof(uint64_t) != (size_t)st.st_size) {
+        printf("Error: Invalid tablebase file %s\n", filename);
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    tb->map = map;
+    tb->mapSize = st.st_size;
+    tb->maxEmpty = header->maxEmpty;
+    const uint64_t* entries = (const uint64_t*)(header + 1);
+    for (int k = 0; k <= tb->maxEmpty; k++) {
+        tb->layers[k] = entries;
+        tb->counts[k] = header->counts[k];
+        entries += header->counts[k];
+    }
+    printf("Tablebase loaded: %s (<= %d empty fields, %llu positions)\n",
+           filename, tb->maxEmpty, (unsigned long long)total);
+    return true;
+}
+
+void tbClose(Tablebase* tb) {
+    if (tb->map) munmap(tb->map, tb->mapSize);
+    memset(tb, 0, sizeof(*tb));
+    tb->maxEmpty = -1;
+}
+
+bool tbLookup(const Tablebase* tb, int empty, uint64_t code, int* value) {
+    int found = lookupLayer(tb->layers[empty], tb->counts[empty], code);
+    if (found < EG_LOSS) return false;
+    *value = found;
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bitboard.h"
+
+#define TB_MAX_EMPTY 8
+#define TB_DEFAULT_EMPTY 5            // ~5.25 mln pozycji kanonicznych (warstwy 0-5), plik ~40 MB
+#define TB_DEFAULT_FILE "endgame_tb.bin"
+#define TB_MAGIC "WSITB01"
+
+// Nagłówek pliku. Po nim warstwy k = 0..maxEmpty (k pustych pól), każda posortowana rosnąco.
+// Wpis: kod kanoniczny pozycji (bbCanonicalCode, 50 bitów) << 2 | (wartość + 1),
+// wartość z perspektywy gracza na ruchu (EG_WIN / EG_DRAW / EG_LOSS).
+typedef struct {
+    char magic[8];
+    uint32_t maxEmpty;
+    uint32_t reserved;
+    uint64_t counts[TB_MAX_EMPTY + 1];
+} TablebaseHeader;
+
+// Tablica końcówek zmapowana w pamięci (mmap) - start bota nie zależy od jej rozmiaru
+typedef struct {
+    void* map;
+    size_t mapSize;
+    const uint64_t* layers[TB_MAX_EMPTY + 1];
+    uint64_t counts[TB_MAX_EMPTY + 1];
+    int maxEmpty;   // -1 = brak tablicy
+} Tablebase;
+
+// Generator offline: wszystkie nieskończone pozycje z co najwyżej maxEmpty pustymi polami
+bool tbGenerate(int maxEmpty, const char* filename);
+
+bool tbOpen(Tablebase* tb, const char* filename);
+void tbClose(Tablebase* tb);
+
+// Wartość pozycji o kodzie kanonicznym 'code' z warstwy 'empty' (false = brak wpisu)
+bool tbLookup(const Tablebase* tb, int empty, uint64_t code, int* value);
+
+// Sondowanie nieskończonej pozycji dla gracza 'toMove' - tylko gdy pustych pól jest <= maxEmpty
+static inline bool tbProbe(const Tablebase* tb, const BitBoard* bb, int toMove, int* value) {
+    if (!tb) return false;
+    int empty = __builtin_popcount(bbEmpty(bb));
+    if (empty > tb->maxEmpty) return false;
+    return tbLookup(tb, empty, bbCanonicalCode(bb, toMove), value);
+}
+
+#endif // TABLEBASE_H
@@ -0,0 +1,132 @@
+#include "transposition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// === PAKOWANIE WPISU ===
+
+static inline uint64_t packEntry(int depth, TTBound bound, int bestCell, int score, unsigned generation) {
+    return (uint64_t)(uint32_t)score
+         | ((uint64_t)(depth & 0xFF) << 32)
+         | ((uint64_t)(bound & 0x3) << 40)
+         | ((uint64_t)((bestCell + 1) & 0x1F) << 42)
+         | ((uint64_t)(generation & 0xFF) << 47);
+}
+
+static inline int entryDepth(uint64_t data) {
+    return (int)((data >> 32) & 0xFF);
+}
+
+static inline unsigned entryGeneration(uint64_t data) {
+    return (unsigned)((data >> 47) & 0xFF);
+}
+
+static inline void unpackEntry(uint64_t data, TTData* out) {
+    out->score = (int32_t)(uint32_t)(data & 0xFFFFFFFFull);
+    out->depth = (int)((data >> 32) & 0xFF);
+    out->bound = (TTBound)((data >> 40) & 0x3);
+    out->bestCell = (int)((data >> 42) & 0x1F) - 1;
+}
+
+// === ZARZĄDZANIE TABLICĄ ===
+
+bool ttInit(TranspositionTable* tt, size_t sizeMB) {
+    if (sizeMB == 0) sizeMB = 1;
+    
+    // Największa potęga dwójki wpisów mieszcząca się w zadanym rozmiarze
+    size_t maxEntries = (sizeMB << 20) / sizeof(TTEntry);
+    size_t count = 1;
+    while (count * 2 <= maxEntries) count *= 2;
+    
+    tt->entries = calloc(count, sizeof(TTEntry));
+    if (!tt->entries) {
+        printf("Error: Cannot allocate %zu MB for transposition table!\n", sizeMB);
+        tt->mask = 0;
+        return false;
+    }
+    tt->mask = count - 1;
+    tt->generation = 0;
+    tt->probes = tt->hits = tt->cutoffs = tt->stores = 0;
+    return true;
+}
+
+void ttClear(TranspositionTable* tt) {
+    if (tt->entries) {
+        memset(tt->entries, 0, (tt->mask + 1) * sizeof(TTEntry));
+    }
+    tt->probes = tt->hits = tt->cutoffs = tt->stores = 0;
+}
+
+// Wpisy z poprzednich ruchów tej samej gry są nadal poprawne (klucz to pozycja, gracz na ruchu
+// i perspektywa oceny) - nowa generacja oznacza je tylko jako pierwsze do nadpisania
+void ttNewSearch(TranspositionTable* tt) {
+    tt->generation = (tt->generation + 1) & 0xFF;
+    tt->probes = tt->hits = tt->cutoffs = tt->stores = 0;
+}
+
+// Tablica wspólna dla wielu równoczesnych przeszukiwań (wiele gier): liczniki są sumami
+// z całej sesji, a generacja rośnie atomowo
+void ttAdvanceGeneration(TranspositionTable* tt) {
+    __atomic_fetch_add(&tt->generation, 1, __ATOMIC_RELAXED);
+}
+
+void ttFree(TranspositionTable* tt) {
+    free(tt->entries);
+    tt->entries = NULL;
+    tt->mask = 0;
+}
+
+void ttPrintStats(const TranspositionTable* tt) {
+    double hitRate = tt->probes ? (tt->hits * 100.0) / tt->probes : 0.0;
+    printf("[TT] entries=%llu probes=%llu hits=%llu (%.1f%%) cutoffs=%llu stores=%llu\n",
+           (unsigned long long)(tt->mask + 1),
+           (unsigned long long)tt->probes,
+           (unsigned long long)tt->hits, hitRate,
+           (unsigned long long)tt->cutoffs,
+           (unsigned long long)tt->stores);
+}
+
+// === UŻYCIE W PRZESZUKIWANIU ===
+
+// Wpisy są czytane i pisane bez blokad przez wszystkie wątki przeszukiwania;
+// niespójna para (check, data) nie przejdzie weryfikacji klucza
+bool ttProbe(TranspositionTable* tt, uint64_t key, TTData* out) {
+    TTEntry* bucket = &tt->entries[key & tt->mask & ~(uint64_t)(TT_BUCKET - 1)];
+    for (int i = 0; i < TT_BUCKET; i++) {
+        uint64_t check = __atomic_load_n(&bucket[i].check, __ATOMIC_RELAXED);
+        uint64_t data = __atomic_load_n(&bucket[i].data, __ATOMIC_RELAXED);
+        if ((check ^ data) != key || data == 0) continue;
+        unpackEntry(data, out);
+        return true;
+    }
+    return false;
+}
+
+bool ttStore(TranspositionTable* tt, uint64_t key, int depth, TTBound bound, int bestCell, int score) {
+    TTEntry* bucket = &tt->entries[key & tt->mask & ~(uint64_t)(TT_BUCKET - 1)];
+    TTEntry* entry = NULL;
+    int victimValue = 0;
+    unsigned generation = __atomic_load_n(&tt->generation, __ATOMIC_RELAXED) & 0xFF;
+    for (int i = 0; i < TT_BUCKET; i++) {
+        uint64_t oldCheck = __atomic_load_n(&bucket[i].check, __ATOMIC_RELAXED);
+        uint64_t oldData = __atomic_load_n(&bucket[i].data, __ATOMIC_RELAXED);
+        if ((oldCheck ^ oldData) == key && oldData != 0) {
+            // Ta sama pozycja przeanalizowana głębiej zostaje
+            if (entryDepth(oldData) > depth) return false;
+            entry = &bucket[i];
+            break;
+        }
+        // Ofiara: pusty slot, potem wpis starszej generacji, potem najpłytszy
+        int value = (oldData == 0) ? -1000 : entryDepth(oldData);
+        if (oldData != 0 && entryGeneration(oldData) != generation) value -= 256;
+        if (entry == NULL || value < victimValue) {
+            entry = &bucket[i];
+            victimValue = value;
+        }
+    }
+    
+    uint64_t data = packEntry(depth, bound, bestCell, score, generation);
+    __atomic_store_n(&entry->check, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->data, data, __ATOMIC_RELAXED);
+    return true;
+}
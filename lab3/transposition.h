@@ -0,0 +1,73 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bitboard.h"
+
+#define TT_DEFAULT_MB 64
+
+// Rodzaj wartości zapisanej w tablicy transpozycji
+typedef enum {
+    TT_EXACT = 0,  // Dokładna wartość minimax
+    TT_LOWER = 1,  // Odcięcie beta - prawdziwa wartość >= score
+    TT_UPPER = 2   // Brak poprawy alfa - prawdziwa wartość <= score
+} TTBound;
+
+// Wpis tablicy: check = klucz XOR data, więc rozerwany zapis z innego wątku
+// nie przejdzie weryfikacji (tablica bez blokad)
+typedef struct {
+    uint64_t check;
+    uint64_t data;   // score (32 bity) | depth (8) | bound (2) | bestCell + 1 (5) | generacja (8)
+} TTEntry;
+
+// Kubełek = 2 sąsiednie wpisy (pół linii cache). Przy braku wolnego miejsca nadpisywany jest wpis
+// z wcześniejszego przeszukiwania (starsza generacja), a wśród równie świeżych - płytszy.
+#define TT_BUCKET 2
+
+// Rozpakowany wpis zwracany przez ttProbe
+typedef struct {
+    int score;
+    int depth;
+    TTBound bound;
+    int bestCell;    // -1 gdy brak najlepszego ruchu (w układzie kanonicznym pozycji)
+} TTData;
+
+typedef struct {
+    TTEntry* entries;
+    uint64_t mask;       // Liczba wpisów - 1 (rozmiar jest potęgą dwójki)
+    unsigned generation; // Numer przeszukiwania (ttNewSearch) - wpisy nie są czyszczone między ruchami
+    // Liczniki do strojenia rozmiaru tablicy (sumy ze wszystkich kontekstów, patrz searchFlushStats)
+    uint64_t probes;
+    uint64_t hits;
+    uint64_t cutoffs;
+    uint64_t stores;
+} TranspositionTable;
+
+// Zarządzanie tablicą
+bool ttInit(TranspositionTable* tt, size_t sizeMB);
+void ttClear(TranspositionTable* tt);
+void ttNewSearch(TranspositionTable* tt);  // Nowa generacja zamiast czyszczenia - stare wpisy zostają
+void ttAdvanceGeneration(TranspositionTable* tt);  // Jak ttNewSearch bez zerowania liczników, bezpieczne z wielu wątków
+void ttFree(TranspositionTable* tt);
+void ttPrintStats(const TranspositionTable* tt);
+
+// Użycie w przeszukiwaniu
+bool ttProbe(TranspositionTable* tt, uint64_t key, TTData* out);
+// Zwraca false, gdy wpis tej samej pozycji z większej głębokości został zachowany
+bool ttStore(TranspositionTable* tt, uint64_t key, int depth, TTBound bound, int bestCell, int score);
+
+// Klucz węzła: kanoniczna pozycja (8 symetrii składa się w jeden klucz) + kto się rusza
+// + czyja perspektywa oceny + typ węzła. *orientation pozwala przeliczyć najlepszy ruch
+// między układem kanonicznym a bieżącym (bbSymCell / bbSymInverse).
+static inline uint64_t ttNodeKey(const BitBoard* bb, int currentPlayer, bool maximizing, int player,
+                                 int* orientation) {
+    static const uint64_t turnKeys[3] = { 0, 0x8F3A6C2D91E4B705ull, 0x27D1B95E4C0A8F63ull };
+    static const uint64_t perspectiveKeys[3] = { 0, 0xC4E8217FA6935B0Dull, 0x5B9F03D2E7186AC4ull };
+    uint64_t key = bbCanonicalHash(bb, orientation) ^ turnKeys[currentPlayer] ^ perspectiveKeys[player];
+    if (maximizing) key ^= 0x9D4C7E1A3F28B65Eull;
+    return key;
+}
+
+#endif // TRANSPOSITION_H